@@ -0,0 +1,407 @@
+///////////////////////////////////////////////////////////////////////////////////////////
+//    MultiNEAT - Python/C++ NeuroEvolution of Augmenting Topologies Library
+//
+//    Copyright (C) 2012 Peter Chervenski
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public License
+//    along with this program.  If not, see < http://www.gnu.org/licenses/ >.
+//
+//    Contact info:
+//
+//    Peter Chervenski < spookey@abv.bg >
+//    Shane Ryan < shane.mcdonald.ryan@gmail.com >
+///////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+// File:        ActivationKernels.cpp
+// Description: Grouped and vectorized evaluation of the activation functions.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <string.h>
+#include <stdint.h>
+#include <algorithm>
+#include "ActivationKernels.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace NEAT
+{
+
+// Applies one activation function to a contiguous run of neurons
+void af_apply(ActivationFunction a_type, const double* x, const double* a,
+                     const double* b, double* y, unsigned int n)
+{
+    switch (a_type)
+    {
+    case SIGNED_SIGMOID:
+        for (unsigned int k = 0; k < n; k++) y[k] = af_sigmoid_signed(x[k], a[k], b[k]);
+        break;
+    case UNSIGNED_SIGMOID:
+        for (unsigned int k = 0; k < n; k++) y[k] = af_sigmoid_unsigned(x[k], a[k], b[k]);
+        break;
+    case TANH:
+        for (unsigned int k = 0; k < n; k++) y[k] = af_tanh(x[k], a[k], b[k]);
+        break;
+    case TANH_CUBIC:
+        for (unsigned int k = 0; k < n; k++) y[k] = af_tanh_cubic(x[k], a[k], b[k]);
+        break;
+    case SIGNED_STEP:
+        for (unsigned int k = 0; k < n; k++) y[k] = af_step_signed(x[k], b[k]);
+        break;
+    case UNSIGNED_STEP:
+        for (unsigned int k = 0; k < n; k++) y[k] = af_step_unsigned(x[k], b[k]);
+        break;
+    case SIGNED_GAUSS:
+        for (unsigned int k = 0; k < n; k++) y[k] = af_gauss_signed(x[k], a[k], b[k]);
+        break;
+    case UNSIGNED_GAUSS:
+        for (unsigned int k = 0; k < n; k++) y[k] = af_gauss_unsigned(x[k], a[k], b[k]);
+        break;
+    case ABS:
+        for (unsigned int k = 0; k < n; k++) y[k] = af_abs(x[k], b[k]);
+        break;
+    case SIGNED_SINE:
+        for (unsigned int k = 0; k < n; k++) y[k] = af_sine_signed(x[k], a[k], b[k]);
+        break;
+    case UNSIGNED_SINE:
+        for (unsigned int k = 0; k < n; k++) y[k] = af_sine_unsigned(x[k], a[k], b[k]);
+        break;
+    case SIGNED_SQUARE:
+        for (unsigned int k = 0; k < n; k++) y[k] = af_square_signed(x[k], a[k], b[k]);
+        break;
+    case UNSIGNED_SQUARE:
+        for (unsigned int k = 0; k < n; k++) y[k] = af_square_unsigned(x[k], a[k], b[k]);
+        break;
+    case LINEAR:
+        for (unsigned int k = 0; k < n; k++) y[k] = af_linear(x[k], b[k]);
+        break;
+    default:
+        for (unsigned int k = 0; k < n; k++) y[k] = af_sigmoid_unsigned(x[k], a[k], b[k]);
+        break;
+    }
+}
+
+/////////////////////////////////////
+// Vectorized approximations       //
+/////////////////////////////////////
+
+// exp(x) = 2^n * exp(r), n = round(x / ln2), |r| <= ln2/2
+// exp(r) is the degree 11 Taylor polynomial, the truncation error is below 6e-15.
+// 2^n is assembled directly in the exponent bits.
+static const double EXP_MIN = -708.0;
+static const double EXP_MAX = 709.0;
+static const double EXP_LOG2E = 1.44269504088896338700e+00;
+static const double EXP_LN2_HI = 6.93145751953125000000e-01;
+static const double EXP_LN2_LO = 1.42860682030941723212e-06;
+// adding this rounds to the nearest integer and leaves it in the low mantissa bits
+static const double ROUND_MAGIC = 6755399441055744.0; // 1.5 * 2^52
+
+static const double EXP_C[12] =
+{
+    1.0, 1.0, 1.0 / 2.0, 1.0 / 6.0, 1.0 / 24.0, 1.0 / 120.0, 1.0 / 720.0, 1.0 / 5040.0,
+    1.0 / 40320.0, 1.0 / 362880.0, 1.0 / 3628800.0, 1.0 / 39916800.0
+};
+
+// sin(x): reduce to r in [-pi, pi], fold to [-pi/2, pi/2] with sin(pi - r) = sin(r),
+// then the odd Taylor polynomial up to r^19, the truncation error is below 1e-16.
+static const double SIN_INV_2PI = 1.59154943091895335769e-01;
+static const double SIN_2PI_HI = 6.28318530717958623200e+00;
+static const double SIN_2PI_LO = 2.44929359829470635445e-16;
+static const double SIN_PI = 3.14159265358979311600e+00;
+// the reduction needs x / 2pi to fit the mantissa below ROUND_MAGIC,
+// larger arguments (and inf and NaN) go to std::sin()
+static const double SIN_MAX_REDUCED = 1125899906842624.0; // 2^50
+
+static const double SIN_C[9] =
+{
+    -1.0 / 6.0, 1.0 / 120.0, -1.0 / 5040.0, 1.0 / 362880.0, -1.0 / 39916800.0,
+    1.0 / 6227020800.0, -1.0 / 1307674368000.0, 1.0 / 355687428096000.0,
+    -1.0 / 121645100408832000.0
+};
+
+inline double fast_exp_scalar(double x)
+{
+    x = std::min(std::max(x, EXP_MIN), EXP_MAX);
+
+    double t = x * EXP_LOG2E + ROUND_MAGIC;
+    double n = t - ROUND_MAGIC;
+    double r = (x - n * EXP_LN2_HI) - n * EXP_LN2_LO;
+
+    double p = EXP_C[11];
+    for (int i = 10; i >= 0; i--)
+        p = p * r + EXP_C[i];
+
+    int64_t t_bits, t_magic_bits;
+    memcpy(&t_bits, &t, sizeof(t_bits));
+    memcpy(&t_magic_bits, &ROUND_MAGIC, sizeof(t_magic_bits));
+    int64_t t_scale_bits = (t_bits - t_magic_bits + 1023) << 52;
+    double t_scale;
+    memcpy(&t_scale, &t_scale_bits, sizeof(t_scale));
+
+    return p * t_scale;
+}
+
+inline double fast_sin_scalar(double x)
+{
+    if (!(std::fabs(x) <= SIN_MAX_REDUCED))
+        return std::sin(x);
+
+    double t = x * SIN_INV_2PI + ROUND_MAGIC;
+    double k = t - ROUND_MAGIC;
+    double r = (x - k * SIN_2PI_HI) - k * SIN_2PI_LO;
+
+    // fold [-pi, pi] into [-pi/2, pi/2]
+    r = std::max(std::min(r, SIN_PI - r), -SIN_PI - r);
+
+    double r2 = r * r;
+    double p = SIN_C[8];
+    for (int i = 7; i >= 0; i--)
+        p = p * r2 + SIN_C[i];
+
+    return r + r * r2 * p;
+}
+
+#if defined(__AVX2__)
+
+void fast_exp(const double* x, double* y, unsigned int n)
+{
+    const __m256d t_min = _mm256_set1_pd(EXP_MIN);
+    const __m256d t_max = _mm256_set1_pd(EXP_MAX);
+    const __m256d t_log2e = _mm256_set1_pd(EXP_LOG2E);
+    const __m256d t_ln2_hi = _mm256_set1_pd(EXP_LN2_HI);
+    const __m256d t_ln2_lo = _mm256_set1_pd(EXP_LN2_LO);
+    const __m256d t_magic = _mm256_set1_pd(ROUND_MAGIC);
+    const __m256i t_bias = _mm256_set1_epi64x(1023);
+
+    unsigned int i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m256d v = _mm256_loadu_pd(x + i);
+        v = _mm256_min_pd(_mm256_max_pd(v, t_min), t_max);
+
+        __m256d t = _mm256_add_pd(_mm256_mul_pd(v, t_log2e), t_magic);
+        __m256d k = _mm256_sub_pd(t, t_magic);
+        __m256d r = _mm256_sub_pd(_mm256_sub_pd(v, _mm256_mul_pd(k, t_ln2_hi)), _mm256_mul_pd(k, t_ln2_lo));
+
+        __m256d p = _mm256_set1_pd(EXP_C[11]);
+        for (int j = 10; j >= 0; j--)
+            p = _mm256_add_pd(_mm256_mul_pd(p, r), _mm256_set1_pd(EXP_C[j]));
+
+        __m256i e = _mm256_sub_epi64(_mm256_castpd_si256(t), _mm256_castpd_si256(t_magic));
+        e = _mm256_slli_epi64(_mm256_add_epi64(e, t_bias), 52);
+
+        _mm256_storeu_pd(y + i, _mm256_mul_pd(p, _mm256_castsi256_pd(e)));
+    }
+    for (; i < n; i++)
+        y[i] = fast_exp_scalar(x[i]);
+}
+
+void fast_sin(const double* x, double* y, unsigned int n)
+{
+    const __m256d t_inv_2pi = _mm256_set1_pd(SIN_INV_2PI);
+    const __m256d t_2pi_hi = _mm256_set1_pd(SIN_2PI_HI);
+    const __m256d t_2pi_lo = _mm256_set1_pd(SIN_2PI_LO);
+    const __m256d t_pi = _mm256_set1_pd(SIN_PI);
+    const __m256d t_neg_pi = _mm256_set1_pd(-SIN_PI);
+    const __m256d t_magic = _mm256_set1_pd(ROUND_MAGIC);
+    const __m256d t_max_reduced = _mm256_set1_pd(SIN_MAX_REDUCED);
+    const __m256d t_sign = _mm256_set1_pd(-0.0);
+
+    unsigned int i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m256d v = _mm256_loadu_pd(x + i);
+
+        // the lanes that can't be reduced, NaN included
+        int t_large = _mm256_movemask_pd(_mm256_cmp_pd(_mm256_andnot_pd(t_sign, v), t_max_reduced, _CMP_NLE_UQ));
+
+        __m256d k = _mm256_sub_pd(_mm256_add_pd(_mm256_mul_pd(v, t_inv_2pi), t_magic), t_magic);
+        __m256d r = _mm256_sub_pd(_mm256_sub_pd(v, _mm256_mul_pd(k, t_2pi_hi)), _mm256_mul_pd(k, t_2pi_lo));
+        r = _mm256_max_pd(_mm256_min_pd(r, _mm256_sub_pd(t_pi, r)), _mm256_sub_pd(t_neg_pi, r));
+
+        __m256d r2 = _mm256_mul_pd(r, r);
+        __m256d p = _mm256_set1_pd(SIN_C[8]);
+        for (int j = 7; j >= 0; j--)
+            p = _mm256_add_pd(_mm256_mul_pd(p, r2), _mm256_set1_pd(SIN_C[j]));
+
+        _mm256_storeu_pd(y + i, _mm256_add_pd(r, _mm256_mul_pd(_mm256_mul_pd(r, r2), p)));
+
+        if (t_large)
+        {
+            // y may be x, take the arguments from v
+            double t_args[4];
+            _mm256_storeu_pd(t_args, v);
+            for (int j = 0; j < 4; j++)
+                if (t_large & (1 << j))
+                    y[i + j] = std::sin(t_args[j]);
+        }
+    }
+    for (; i < n; i++)
+        y[i] = fast_sin_scalar(x[i]);
+}
+
+#elif defined(__SSE2__)
+
+void fast_exp(const double* x, double* y, unsigned int n)
+{
+    const __m128d t_min = _mm_set1_pd(EXP_MIN);
+    const __m128d t_max = _mm_set1_pd(EXP_MAX);
+    const __m128d t_log2e = _mm_set1_pd(EXP_LOG2E);
+    const __m128d t_ln2_hi = _mm_set1_pd(EXP_LN2_HI);
+    const __m128d t_ln2_lo = _mm_set1_pd(EXP_LN2_LO);
+    const __m128d t_magic = _mm_set1_pd(ROUND_MAGIC);
+    const __m128i t_bias = _mm_set1_epi64x(1023);
+
+    unsigned int i = 0;
+    for (; i + 2 <= n; i += 2)
+    {
+        __m128d v = _mm_loadu_pd(x + i);
+        v = _mm_min_pd(_mm_max_pd(v, t_min), t_max);
+
+        __m128d t = _mm_add_pd(_mm_mul_pd(v, t_log2e), t_magic);
+        __m128d k = _mm_sub_pd(t, t_magic);
+        __m128d r = _mm_sub_pd(_mm_sub_pd(v, _mm_mul_pd(k, t_ln2_hi)), _mm_mul_pd(k, t_ln2_lo));
+
+        __m128d p = _mm_set1_pd(EXP_C[11]);
+        for (int j = 10; j >= 0; j--)
+            p = _mm_add_pd(_mm_mul_pd(p, r), _mm_set1_pd(EXP_C[j]));
+
+        __m128i e = _mm_sub_epi64(_mm_castpd_si128(t), _mm_castpd_si128(t_magic));
+        e = _mm_slli_epi64(_mm_add_epi64(e, t_bias), 52);
+
+        _mm_storeu_pd(y + i, _mm_mul_pd(p, _mm_castsi128_pd(e)));
+    }
+    for (; i < n; i++)
+        y[i] = fast_exp_scalar(x[i]);
+}
+
+void fast_sin(const double* x, double* y, unsigned int n)
+{
+    const __m128d t_inv_2pi = _mm_set1_pd(SIN_INV_2PI);
+    const __m128d t_2pi_hi = _mm_set1_pd(SIN_2PI_HI);
+    const __m128d t_2pi_lo = _mm_set1_pd(SIN_2PI_LO);
+    const __m128d t_pi = _mm_set1_pd(SIN_PI);
+    const __m128d t_neg_pi = _mm_set1_pd(-SIN_PI);
+    const __m128d t_magic = _mm_set1_pd(ROUND_MAGIC);
+    const __m128d t_max_reduced = _mm_set1_pd(SIN_MAX_REDUCED);
+    const __m128d t_sign = _mm_set1_pd(-0.0);
+
+    unsigned int i = 0;
+    for (; i + 2 <= n; i += 2)
+    {
+        __m128d v = _mm_loadu_pd(x + i);
+
+        // the lanes that can't be reduced, NaN included
+        int t_large = _mm_movemask_pd(_mm_cmpnle_pd(_mm_andnot_pd(t_sign, v), t_max_reduced));
+
+        __m128d k = _mm_sub_pd(_mm_add_pd(_mm_mul_pd(v, t_inv_2pi), t_magic), t_magic);
+        __m128d r = _mm_sub_pd(_mm_sub_pd(v, _mm_mul_pd(k, t_2pi_hi)), _mm_mul_pd(k, t_2pi_lo));
+        r = _mm_max_pd(_mm_min_pd(r, _mm_sub_pd(t_pi, r)), _mm_sub_pd(t_neg_pi, r));
+
+        __m128d r2 = _mm_mul_pd(r, r);
+        __m128d p = _mm_set1_pd(SIN_C[8]);
+        for (int j = 7; j >= 0; j--)
+            p = _mm_add_pd(_mm_mul_pd(p, r2), _mm_set1_pd(SIN_C[j]));
+
+        _mm_storeu_pd(y + i, _mm_add_pd(r, _mm_mul_pd(_mm_mul_pd(r, r2), p)));
+
+        if (t_large)
+        {
+            // y may be x, take the arguments from v
+            double t_args[2];
+            _mm_storeu_pd(t_args, v);
+            for (int j = 0; j < 2; j++)
+                if (t_large & (1 << j))
+                    y[i + j] = std::sin(t_args[j]);
+        }
+    }
+    for (; i < n; i++)
+        y[i] = fast_sin_scalar(x[i]);
+}
+
+#else
+
+void fast_exp(const double* x, double* y, unsigned int n)
+{
+    for (unsigned int i = 0; i < n; i++)
+        y[i] = fast_exp_scalar(x[i]);
+}
+
+void fast_sin(const double* x, double* y, unsigned int n)
+{
+    for (unsigned int i = 0; i < n; i++)
+        y[i] = fast_sin_scalar(x[i]);
+}
+
+#endif
+
+
+void af_apply_fast(ActivationFunction a_type, const double* x, const double* a,
+                   const double* b, double* y, unsigned int n)
+{
+    // The argument is computed into y, run through the approximation in place
+    // and then finished. All loops here are simple enough to be auto-vectorized.
+    switch (a_type)
+    {
+    case SIGNED_SIGMOID:
+        for (unsigned int k = 0; k < n; k++) y[k] = - a[k] * x[k] - b[k];
+        fast_exp(y, y, n);
+        for (unsigned int k = 0; k < n; k++) y[k] = (1.0 / (1.0 + y[k]) - 0.5) * 2.0;
+        break;
+    case UNSIGNED_SIGMOID:
+        for (unsigned int k = 0; k < n; k++) y[k] = - a[k] * x[k] - b[k];
+        fast_exp(y, y, n);
+        for (unsigned int k = 0; k < n; k++) y[k] = 1.0 / (1.0 + y[k]);
+        break;
+    case TANH:
+        // tanh(z) = 1 - 2 / (exp(2z) + 1)
+        for (unsigned int k = 0; k < n; k++) y[k] = 2.0 * x[k] * a[k];
+        fast_exp(y, y, n);
+        for (unsigned int k = 0; k < n; k++) y[k] = 1.0 - 2.0 / (y[k] + 1.0);
+        break;
+    case TANH_CUBIC:
+        for (unsigned int k = 0; k < n; k++) y[k] = 2.0 * x[k] * x[k] * x[k] * a[k];
+        fast_exp(y, y, n);
+        for (unsigned int k = 0; k < n; k++) y[k] = 1.0 - 2.0 / (y[k] + 1.0);
+        break;
+    case SIGNED_GAUSS:
+        for (unsigned int k = 0; k < n; k++) y[k] = - a[k] * x[k] * x[k] + b[k];
+        fast_exp(y, y, n);
+        for (unsigned int k = 0; k < n; k++) y[k] = (y[k] - 0.5) * 2.0;
+        break;
+    case UNSIGNED_GAUSS:
+        for (unsigned int k = 0; k < n; k++) y[k] = - a[k] * x[k] * x[k] + b[k];
+        fast_exp(y, y, n);
+        break;
+    case SIGNED_SINE:
+        // af_sine_signed() always uses pi as the frequency
+        for (unsigned int k = 0; k < n; k++) y[k] = x[k] * 3.141592 + b[k];
+        fast_sin(y, y, n);
+        break;
+    case UNSIGNED_SINE:
+        for (unsigned int k = 0; k < n; k++) y[k] = x[k] * a[k] + b[k];
+        fast_sin(y, y, n);
+        for (unsigned int k = 0; k < n; k++) y[k] = (y[k] + 1.0) / 2.0;
+        break;
+    default:
+        // the rest have nothing to approximate
+        af_apply(a_type, x, a, b, y, n);
+        break;
+    }
+}
+
+} // namespace NEAT
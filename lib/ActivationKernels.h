@@ -0,0 +1,206 @@
+#ifndef _ACTIVATIONKERNELS_H
+#define _ACTIVATIONKERNELS_H
+
+///////////////////////////////////////////////////////////////////////////////////////////
+//    MultiNEAT - Python/C++ NeuroEvolution of Augmenting Topologies Library
+//
+//    Copyright (C) 2012 Peter Chervenski
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public License
+//    along with this program.  If not, see < http://www.gnu.org/licenses/ >.
+//
+//    Contact info:
+//
+//    Peter Chervenski < spookey@abv.bg >
+//    Shane Ryan < shane.mcdonald.ryan@gmail.com >
+///////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+// File:        ActivationKernels.h
+// Description: The activation functions, one value at a time and in bulk.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <math.h>
+#include "Genes.h"
+
+namespace NEAT
+{
+
+/////////////////////////////////////
+// The set of activation functions //
+/////////////////////////////////////
+
+
+inline double af_sigmoid_unsigned(double aX, double aSlope, double aShift)
+{
+    return 1.0 / (1.0 + exp( - aSlope * aX - aShift));
+}
+
+inline double af_sigmoid_signed(double aX, double aSlope, double aShift)
+{
+    double tY = af_sigmoid_unsigned(aX, aSlope, aShift);
+    return (tY - 0.5) * 2.0;
+}
+
+
+inline double af_tanh(double aX, double aSlope, double aShift)
+{
+    return tanh(aX * aSlope);
+}
+
+inline double af_tanh_cubic(double aX, double aSlope, double aShift)
+{
+    return tanh(aX * aX * aX * aSlope);
+}
+
+inline double af_step_signed(double aX, double aShift)
+{
+    double tY;
+    if (aX > aShift)
+    {
+        tY = 1.0;
+    }
+    else
+    {
+        tY = -1.0;
+    }
+
+    return tY;
+}
+
+inline double af_step_unsigned(double aX, double aShift)
+{
+    if (aX > aShift)
+    {
+        return 1.0;
+    }
+    else
+    {
+        return 0.0;
+    }
+}
+
+inline double af_gauss_signed(double aX, double aSlope, double aShift)
+{
+    double tY = exp( - aSlope * aX * aX + aShift);
+    return (tY-0.5)*2.0;
+}
+
+inline double af_gauss_unsigned(double aX, double aSlope, double aShift)
+{
+    return exp( - aSlope * aX * aX + aShift);
+}
+
+inline double af_abs(double aX, double aShift)
+{
+    return ((aX + aShift)< 0.0)? -(aX + aShift): (aX + aShift);
+}
+
+inline double af_sine_signed(double aX, double aFreq, double aShift)
+{
+    aFreq = 3.141592;
+    return sin(aX * aFreq + aShift);
+}
+
+inline double af_sine_unsigned(double aX, double aFreq, double aShift)
+{
+    double tY = sin((aX * aFreq + aShift) );
+    return (tY + 1.0) / 2.0;
+}
+
+inline double af_square_signed(double aX, double aHighPulseSize, double aLowPulseSize)
+{
+    return 0.0;    // TODO
+}
+
+inline double af_square_unsigned(double aX, double aHighPulseSize, double aLowPulseSize)
+{
+    return 0.0;    // TODO
+}
+
+inline double af_linear(double aX, double aShift)
+{
+    return (aX + aShift);
+}
+
+// Applies the given activation function to a single value
+inline double af_eval(ActivationFunction a_type, double x, double a, double b)
+{
+    switch (a_type)
+    {
+    case SIGNED_SIGMOID:
+        return af_sigmoid_signed(x, a, b);
+    case UNSIGNED_SIGMOID:
+        return af_sigmoid_unsigned(x, a, b);
+    case TANH:
+        return af_tanh(x, a, b);
+    case TANH_CUBIC:
+        return af_tanh_cubic(x, a, b);
+    case SIGNED_STEP:
+        return af_step_signed(x, b);
+    case UNSIGNED_STEP:
+        return af_step_unsigned(x, b);
+    case SIGNED_GAUSS:
+        return af_gauss_signed(x, a, b);
+    case UNSIGNED_GAUSS:
+        return af_gauss_unsigned(x, a, b);
+    case ABS:
+        return af_abs(x, b);
+    case SIGNED_SINE:
+        return af_sine_signed(x, a, b);
+    case UNSIGNED_SINE:
+        return af_sine_unsigned(x, a, b);
+    case SIGNED_SQUARE:
+        return af_square_signed(x, a, b);
+    case UNSIGNED_SQUARE:
+        return af_square_unsigned(x, a, b);
+    case LINEAR:
+        return af_linear(x, b);
+    default:
+        return af_sigmoid_unsigned(x, a, b);
+    }
+}
+
+
+/////////////////////////////////////
+// Bulk (grouped) evaluation       //
+/////////////////////////////////////
+
+// Applies one activation function to n neurons at once.
+// x holds the net inputs, a and b the per-neuron slope/shift parameters.
+// Gives exactly the same results as calling af_eval() for each neuron.
+void af_apply(ActivationFunction a_type, const double* x, const double* a,
+              const double* b, double* y, unsigned int n);
+
+// Like af_apply(), but the exp() and sin() based functions use vectorized
+// polynomial approximations instead of the C library (SSE2, or AVX2 when compiled
+// with -mavx2, with a scalar fallback). The remaining functions are exact.
+//
+// Worst case error against the exact functions (measured over random inputs):
+//     sigmoids, tanh, tanh cubic         absolute error < 1e-14
+//     gaussians                          relative error < 1e-13
+//     sines                              absolute error < 1e-15 + 2e-16 * |argument|
+// The sine approximation covers |argument| <= 2^50, larger arguments (and inf, NaN)
+// are computed by std::sin().
+// exp() arguments are clamped to [-708, 709]. Results that would underflow come
+// out as ~1e-308 instead of zero and results that would overflow as ~8e307 instead of inf.
+void af_apply_fast(ActivationFunction a_type, const double* x, const double* a,
+                   const double* b, double* y, unsigned int n);
+
+// The vector approximations used by af_apply_fast(). In-place use (x == y) is fine.
+void fast_exp(const double* x, double* y, unsigned int n);
+void fast_sin(const double* x, double* y, unsigned int n);
+
+} // namespace NEAT
+
+#endif
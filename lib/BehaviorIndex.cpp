@@ -0,0 +1,284 @@
+///////////////////////////////////////////////////////////////////////////////////////////
+//    MultiNEAT - Python/C++ NeuroEvolution of Augmenting Topologies Library
+//
+//    Copyright (C) 2012 Peter Chervenski
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public License
+//    along with this program.  If not, see < http://www.gnu.org/licenses/ >.
+//
+//    Contact info:
+//
+//    Peter Chervenski < spookey@abv.bg >
+//    Shane Ryan < shane.mcdonald.ryan@gmail.com >
+///////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+// File:        BehaviorIndex.cpp
+// Description: Implementation of the nearest neighbour search in the archive.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <typeinfo>
+#include "BehaviorIndex.h"
+
+namespace NEAT
+{
+
+BehaviorDistanceFunction PrototypeBehaviorDistance(PhenotypeBehavior* a_Prototype)
+{
+    return [a_Prototype](PhenotypeBehavior& a_A, PhenotypeBehavior& a_B) -> double
+    {
+        if (typeid(a_A) == typeid(*a_Prototype))
+            return a_A.Distance_To(&a_B);
+        if (typeid(a_B) == typeid(*a_Prototype))
+            return a_B.Distance_To(&a_A);
+
+        std::swap(a_Prototype->m_Data, a_A.m_Data);
+        double t_distance = a_Prototype->Distance_To(&a_B);
+        std::swap(a_Prototype->m_Data, a_A.m_Data);
+        return t_distance;
+    };
+}
+
+
+void ConsiderNearest(std::vector< std::pair<double, int> >& a_Nearest, double a_Distance, int a_Idx, unsigned int a_K)
+{
+    if (a_Nearest.size() < a_K)
+    {
+        a_Nearest.push_back(std::make_pair(a_Distance, a_Idx));
+        std::push_heap(a_Nearest.begin(), a_Nearest.end());
+    }
+    else if (a_Distance < a_Nearest.front().first)
+    {
+        std::pop_heap(a_Nearest.begin(), a_Nearest.end());
+        a_Nearest.back() = std::make_pair(a_Distance, a_Idx);
+        std::push_heap(a_Nearest.begin(), a_Nearest.end());
+    }
+}
+
+// Appends the heap to a_Result, smaller first
+static void AppendNearest(std::vector< std::pair<double, int> >& a_Nearest, std::vector< std::pair<double, int> >& a_Result)
+{
+    std::sort_heap(a_Nearest.begin(), a_Nearest.end());
+    a_Result.insert(a_Result.end(), a_Nearest.begin(), a_Nearest.end());
+}
+
+
+void BruteForceBehaviorIndex::Update(std::vector<PhenotypeBehavior>& a_Archive)
+{
+    m_Archive = &a_Archive;
+    m_Size = static_cast<unsigned int>(a_Archive.size());
+}
+
+void BruteForceBehaviorIndex::FindNearest(PhenotypeBehavior* a_Query, unsigned int a_K, std::vector< std::pair<double, int> >& a_Nearest) const
+{
+    std::vector< std::pair<double, int> > t_nearest;
+    if (a_K > 0)
+    {
+        for (unsigned int i = 0; i < m_Size; i++)
+        {
+            ConsiderNearest(t_nearest, a_Query->Distance_To(&((*m_Archive)[i])), i, a_K);
+        }
+    }
+
+    AppendNearest(t_nearest, a_Nearest);
+}
+
+
+VPTreeBehaviorIndex::VPTreeBehaviorIndex(const BehaviorDistanceFunction& a_Distance, unsigned int a_BucketSize):
+    m_Distance(a_Distance), m_Archive(NULL), m_BucketSize(a_BucketSize > 1 ? a_BucketSize : 2)
+{
+    Clear();
+}
+
+void VPTreeBehaviorIndex::Clear()
+{
+    m_Size = 0;
+    m_Nodes.clear();
+    m_Nodes.push_back(Node(m_BucketSize));
+    m_Place.clear();
+    m_Pending.clear();
+    m_NumRemovedVantages = 0;
+}
+
+void VPTreeBehaviorIndex::Update(std::vector<PhenotypeBehavior>& a_Archive)
+{
+    // start over if it is another archive or if the removed vantage points
+    // are a large part of the tree
+    if ((m_Archive != &a_Archive) || (a_Archive.size() < m_Size) || (m_NumRemovedVantages * 4 > m_Size))
+    {
+        m_Archive = &a_Archive;
+        Clear();
+    }
+
+    for (unsigned int i = 0; i < m_Pending.size(); i++)
+    {
+        Insert(m_Pending[i]);
+    }
+    m_Pending.clear();
+
+    while (m_Size < a_Archive.size())
+    {
+        m_Place.push_back(-1);
+        Insert(static_cast<int>(m_Size));
+        m_Size++;
+    }
+}
+
+void VPTreeBehaviorIndex::Remove(unsigned int a_Idx)
+{
+    if ((a_Idx >= m_Size) || (m_Place[a_Idx] < 0))
+        return;
+
+    Node& t_node = m_Nodes[m_Place[a_Idx]];
+    if (t_node.m_Vantage == static_cast<int>(a_Idx))
+    {
+        // it still separates the subtrees by its old value
+        t_node.m_RemovedVantage = std::make_shared<PhenotypeBehavior>((*m_Archive)[a_Idx]);
+        m_NumRemovedVantages++;
+    }
+    else
+    {
+        t_node.m_Bucket.erase(std::find(t_node.m_Bucket.begin(), t_node.m_Bucket.end(), static_cast<int>(a_Idx)));
+    }
+
+    m_Place[a_Idx] = -1;
+    m_Pending.push_back(a_Idx);
+}
+
+void VPTreeBehaviorIndex::Insert(int a_Idx)
+{
+    PhenotypeBehavior& t_behavior = (*m_Archive)[a_Idx];
+
+    int t_node = 0;
+    while (m_Nodes[t_node].m_Vantage >= 0)
+    {
+        double t_distance = m_Distance(t_behavior, *Vantage(m_Nodes[t_node]));
+        t_node = (t_distance < m_Nodes[t_node].m_Radius) ? m_Nodes[t_node].m_Inside : m_Nodes[t_node].m_Outside;
+    }
+
+    m_Nodes[t_node].m_Bucket.push_back(a_Idx);
+    m_Place[a_Idx] = t_node;
+    if (m_Nodes[t_node].m_Bucket.size() > m_Nodes[t_node].m_SplitSize)
+    {
+        Split(t_node);
+    }
+}
+
+// Makes a leaf an inner node with the oldest behavior as the vantage point
+// and the median distance to it as the radius
+void VPTreeBehaviorIndex::Split(int a_Node)
+{
+    std::vector<int>& t_bucket = m_Nodes[a_Node].m_Bucket;
+    int t_vantage = t_bucket[0];
+
+    m_Split.clear();
+    for (unsigned int i = 1; i < t_bucket.size(); i++)
+    {
+        m_Split.push_back(std::make_pair(m_Distance((*m_Archive)[t_bucket[i]], (*m_Archive)[t_vantage]), t_bucket[i]));
+    }
+
+    unsigned int t_median = static_cast<unsigned int>(m_Split.size()) / 2;
+    std::nth_element(m_Split.begin(), m_Split.begin() + t_median, m_Split.end());
+    double t_radius = m_Split[t_median].first;
+
+    unsigned int t_num_inside = 0;
+    for (unsigned int i = 0; i < m_Split.size(); i++)
+    {
+        if (m_Split[i].first < t_radius)
+            t_num_inside++;
+    }
+
+    // too many equal distances, it would not separate anything
+    if (t_num_inside == 0)
+    {
+        m_Nodes[a_Node].m_SplitSize = 2 * static_cast<unsigned int>(t_bucket.size());
+        return;
+    }
+
+    int t_inside = static_cast<int>(m_Nodes.size());
+    int t_outside = t_inside + 1;
+
+    Node t_inside_node(m_BucketSize), t_outside_node(m_BucketSize);
+    for (unsigned int i = 0; i < m_Split.size(); i++)
+    {
+        if (m_Split[i].first < t_radius)
+        {
+            t_inside_node.m_Bucket.push_back(m_Split[i].second);
+            m_Place[m_Split[i].second] = t_inside;
+        }
+        else
+        {
+            t_outside_node.m_Bucket.push_back(m_Split[i].second);
+            m_Place[m_Split[i].second] = t_outside;
+        }
+    }
+
+    Node& t_node = m_Nodes[a_Node];
+    t_node.m_Bucket.clear();
+    t_node.m_Vantage = t_vantage;
+    t_node.m_Radius = t_radius;
+    t_node.m_Inside = t_inside;
+    t_node.m_Outside = t_outside;
+
+    // t_node is invalid from here
+    m_Nodes.push_back(t_inside_node);
+    m_Nodes.push_back(t_outside_node);
+}
+
+void VPTreeBehaviorIndex::Search(int a_Node, PhenotypeBehavior* a_Query, unsigned int a_K, std::vector< std::pair<double, int> >& a_Nearest) const
+{
+    const Node& t_node = m_Nodes[a_Node];
+
+    if (t_node.m_Vantage < 0)
+    {
+        for (unsigned int i = 0; i < t_node.m_Bucket.size(); i++)
+        {
+            ConsiderNearest(a_Nearest, m_Distance(*a_Query, (*m_Archive)[t_node.m_Bucket[i]]), t_node.m_Bucket[i], a_K);
+        }
+        return;
+    }
+
+    double t_distance = m_Distance(*a_Query, *Vantage(t_node));
+    if (!t_node.m_RemovedVantage)
+    {
+        ConsiderNearest(a_Nearest, t_distance, t_node.m_Vantage, a_K);
+    }
+
+    // go to the side of the query first, the other side only if it can have something nearer
+    if (t_distance < t_node.m_Radius)
+    {
+        Search(t_node.m_Inside, a_Query, a_K, a_Nearest);
+        if ((a_Nearest.size() < a_K) || (t_distance + a_Nearest.front().first >= t_node.m_Radius))
+            Search(t_node.m_Outside, a_Query, a_K, a_Nearest);
+    }
+    else
+    {
+        Search(t_node.m_Outside, a_Query, a_K, a_Nearest);
+        if ((a_Nearest.size() < a_K) || (t_distance - a_Nearest.front().first < t_node.m_Radius))
+            Search(t_node.m_Inside, a_Query, a_K, a_Nearest);
+    }
+}
+
+void VPTreeBehaviorIndex::FindNearest(PhenotypeBehavior* a_Query, unsigned int a_K, std::vector< std::pair<double, int> >& a_Nearest) const
+{
+    std::vector< std::pair<double, int> > t_nearest;
+    if ((m_Size > 0) && (a_K > 0))
+    {
+        Search(0, a_Query, a_K, t_nearest);
+    }
+
+    AppendNearest(t_nearest, a_Nearest);
+}
+
+} // namespace NEAT
@@ -0,0 +1,175 @@
+#ifndef _BEHAVIORINDEX_H
+#define _BEHAVIORINDEX_H
+
+///////////////////////////////////////////////////////////////////////////////////////////
+//    MultiNEAT - Python/C++ NeuroEvolution of Augmenting Topologies Library
+//
+//    Copyright (C) 2012 Peter Chervenski
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public License
+//    along with this program.  If not, see < http://www.gnu.org/licenses/ >.
+//
+//    Contact info:
+//
+//    Peter Chervenski < spookey@abv.bg >
+//    Shane Ryan < shane.mcdonald.ryan@gmail.com >
+///////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+// File:        BehaviorIndex.h
+// Description: Nearest neighbour search in the novelty search archive.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+#include <utility>
+#include <memory>
+#include <functional>
+#include "PhenotypeBehavior.h"
+
+namespace NEAT
+{
+
+// The distance between two behaviors
+typedef std::function<double (PhenotypeBehavior&, PhenotypeBehavior&)> BehaviorDistanceFunction;
+
+// Compares behaviors with the Distance_To() of a behavior of the user's type.
+// The archive keeps its behaviors as plain PhenotypeBehavior copies, their own Distance_To() is the base one.
+// A behavior of the user's type is asked directly. For two copies, the m_Data of the first one
+// is swapped into a_Prototype for the call, so a_Prototype must not be used meanwhile.
+// This is the same distance because the derived behaviors have no members of their own.
+BehaviorDistanceFunction PrototypeBehaviorDistance(PhenotypeBehavior* a_Prototype);
+
+// Keeps the a_K nearest in a_Nearest as (distance, index), a max-heap on the distance
+void ConsiderNearest(std::vector< std::pair<double, int> >& a_Nearest, double a_Distance, int a_Idx, unsigned int a_K);
+
+
+// Finds the behaviors of the archive nearest to a query behavior.
+// The index follows the archive incrementally: Update() indexes the behaviors appended
+// since the last call and the ones given to Remove().
+// The behaviors are kept as indexes into the archive, it may reallocate.
+// FindNearest() may be called from several threads at once, the rest may not.
+class BehaviorIndex
+{
+public:
+    virtual ~BehaviorIndex() {}
+
+    // Indexes the new behaviors of a_Archive. If it is another archive
+    // or it got shorter, everything is indexed again.
+    virtual void Update(std::vector<PhenotypeBehavior>& a_Archive) = 0;
+
+    // Call before the behavior a_Idx of the archive is overwritten.
+    // It is out of the index until the next Update(), which indexes its new value.
+    virtual void Remove(unsigned int a_Idx) = 0;
+
+    // Appends to a_Nearest the a_K nearest indexed behaviors to a_Query (all of them if there are fewer)
+    // as (distance, archive index), smaller first.
+    // a_Query must be of the user's behavior type, not an archive copy.
+    virtual void FindNearest(PhenotypeBehavior* a_Query, unsigned int a_K, std::vector< std::pair<double, int> >& a_Nearest) const = 0;
+
+    // How many behaviors are indexed
+    virtual unsigned int Size() const = 0;
+};
+
+
+// Computes the distance to every behavior and keeps the K smallest.
+// Works with any Distance_To().
+class BruteForceBehaviorIndex : public BehaviorIndex
+{
+    std::vector<PhenotypeBehavior>* m_Archive;
+    unsigned int m_Size;
+
+public:
+    BruteForceBehaviorIndex(): m_Archive(NULL), m_Size(0) {}
+
+    virtual void Update(std::vector<PhenotypeBehavior>& a_Archive);
+    virtual void Remove(unsigned int /*a_Idx*/) {}
+    virtual void FindNearest(PhenotypeBehavior* a_Query, unsigned int a_K, std::vector< std::pair<double, int> >& a_Nearest) const;
+    virtual unsigned int Size() const { return m_Size; }
+};
+
+
+// A vantage-point tree. Each inner node splits its behaviors by the distance to
+// a vantage point, searches skip the subtrees that can't have nearer behaviors.
+// The skipping is only exact if Distance_To() is a metric (symmetric, obeys the triangle inequality),
+// for example the Euclidean distance between the m_Data vectors.
+// The distances are computed by the BehaviorDistanceFunction given to the constructor,
+// never by the Distance_To() of an archive behavior.
+// New behaviors go down to a leaf, a leaf is split when it gets too large.
+// A leaf whose behaviors are all at the same distance can't be split, it is tried again when it doubles.
+// A removed vantage point keeps a copy of its old value to route by, the tree is
+// built again when too many of them are left.
+class VPTreeBehaviorIndex : public BehaviorIndex
+{
+    struct Node
+    {
+        // archive index of the vantage point, -1 for a leaf
+        int m_Vantage;
+
+        // the old value of a removed vantage point, it is not a result anymore
+        std::shared_ptr<PhenotypeBehavior> m_RemovedVantage;
+
+        // the behaviors nearer than this to the vantage point are in m_Inside, the others in m_Outside
+        double m_Radius;
+        int m_Inside;
+        int m_Outside;
+
+        // the behaviors of a leaf
+        std::vector<int> m_Bucket;
+
+        // the leaf is split when its bucket gets larger than this
+        unsigned int m_SplitSize;
+
+        Node(unsigned int a_SplitSize = 0): m_Vantage(-1), m_Radius(0), m_Inside(-1), m_Outside(-1), m_SplitSize(a_SplitSize) {}
+    };
+
+    BehaviorDistanceFunction m_Distance;
+    std::vector<PhenotypeBehavior>* m_Archive;
+    unsigned int m_Size;
+    std::vector<Node> m_Nodes;
+
+    // the node having each behavior (as the vantage point or in the bucket), -1 if it is not in the tree
+    std::vector<int> m_Place;
+
+    // removed behaviors waiting for Update()
+    std::vector<int> m_Pending;
+    unsigned int m_NumRemovedVantages;
+
+    // the largest leaf
+    unsigned int m_BucketSize;
+
+    std::vector< std::pair<double, int> > m_Split;
+
+    void Clear();
+    void Insert(int a_Idx);
+    void Split(int a_Node);
+
+    // a_Nearest has the K nearest found so far as (distance, index), a max-heap on the distance
+    void Search(int a_Node, PhenotypeBehavior* a_Query, unsigned int a_K, std::vector< std::pair<double, int> >& a_Nearest) const;
+
+    PhenotypeBehavior* Vantage(const Node& a_Node) const
+    {
+        return a_Node.m_RemovedVantage ? a_Node.m_RemovedVantage.get() : &((*m_Archive)[a_Node.m_Vantage]);
+    }
+
+public:
+    VPTreeBehaviorIndex(const BehaviorDistanceFunction& a_Distance, unsigned int a_BucketSize = 16);
+
+    virtual void Update(std::vector<PhenotypeBehavior>& a_Archive);
+    virtual void Remove(unsigned int a_Idx);
+    virtual void FindNearest(PhenotypeBehavior* a_Query, unsigned int a_K, std::vector< std::pair<double, int> >& a_Nearest) const;
+    virtual unsigned int Size() const { return m_Size; }
+};
+
+} // namespace NEAT
+
+#endif
@@ -0,0 +1,215 @@
+///////////////////////////////////////////////////////////////////////////////////////////
+//    MultiNEAT - Python/C++ NeuroEvolution of Augmenting Topologies Library
+//
+//    Copyright (C) 2012 Peter Chervenski
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public License
+//    along with this program.  If not, see < http://www.gnu.org/licenses/ >.
+//
+//    Contact info:
+//
+//    Peter Chervenski < spookey@abv.bg >
+//    Shane Ryan < shane.mcdonald.ryan@gmail.com >
+///////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+// File:        BehaviorStore.cpp
+// Description: Implementation of the behavior matrix and the distance kernels.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <math.h>
+#include <algorithm>
+#include "BehaviorStore.h"
+#include "Assert.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace NEAT
+{
+
+#if defined(__AVX2__)
+
+static double sum_squared_differences(const double* a, const double* b, unsigned int n)
+{
+    __m256d t_sum = _mm256_setzero_pd();
+    unsigned int i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m256d d = _mm256_sub_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i));
+        t_sum = _mm256_add_pd(t_sum, _mm256_mul_pd(d, d));
+    }
+
+    double t_lanes[4];
+    _mm256_storeu_pd(t_lanes, t_sum);
+    double t_result = (t_lanes[0] + t_lanes[1]) + (t_lanes[2] + t_lanes[3]);
+    for (; i < n; i++)
+        t_result += (a[i] - b[i]) * (a[i] - b[i]);
+    return t_result;
+}
+
+static double sum_absolute_differences(const double* a, const double* b, unsigned int n)
+{
+    const __m256d t_abs_mask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7fffffffffffffffLL));
+    __m256d t_sum = _mm256_setzero_pd();
+    unsigned int i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m256d d = _mm256_sub_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i));
+        t_sum = _mm256_add_pd(t_sum, _mm256_and_pd(d, t_abs_mask));
+    }
+
+    double t_lanes[4];
+    _mm256_storeu_pd(t_lanes, t_sum);
+    double t_result = (t_lanes[0] + t_lanes[1]) + (t_lanes[2] + t_lanes[3]);
+    for (; i < n; i++)
+        t_result += fabs(a[i] - b[i]);
+    return t_result;
+}
+
+#elif defined(__SSE2__)
+
+static double sum_squared_differences(const double* a, const double* b, unsigned int n)
+{
+    __m128d t_sum = _mm_setzero_pd();
+    unsigned int i = 0;
+    for (; i + 2 <= n; i += 2)
+    {
+        __m128d d = _mm_sub_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i));
+        t_sum = _mm_add_pd(t_sum, _mm_mul_pd(d, d));
+    }
+
+    double t_lanes[2];
+    _mm_storeu_pd(t_lanes, t_sum);
+    double t_result = t_lanes[0] + t_lanes[1];
+    for (; i < n; i++)
+        t_result += (a[i] - b[i]) * (a[i] - b[i]);
+    return t_result;
+}
+
+static double sum_absolute_differences(const double* a, const double* b, unsigned int n)
+{
+    const __m128d t_abs_mask = _mm_castsi128_pd(_mm_set1_epi64x(0x7fffffffffffffffLL));
+    __m128d t_sum = _mm_setzero_pd();
+    unsigned int i = 0;
+    for (; i + 2 <= n; i += 2)
+    {
+        __m128d d = _mm_sub_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i));
+        t_sum = _mm_add_pd(t_sum, _mm_and_pd(d, t_abs_mask));
+    }
+
+    double t_lanes[2];
+    _mm_storeu_pd(t_lanes, t_sum);
+    double t_result = t_lanes[0] + t_lanes[1];
+    for (; i < n; i++)
+        t_result += fabs(a[i] - b[i]);
+    return t_result;
+}
+
+#else
+
+static double sum_squared_differences(const double* a, const double* b, unsigned int n)
+{
+    double t_result = 0;
+    for (unsigned int i = 0; i < n; i++)
+        t_result += (a[i] - b[i]) * (a[i] - b[i]);
+    return t_result;
+}
+
+static double sum_absolute_differences(const double* a, const double* b, unsigned int n)
+{
+    double t_result = 0;
+    for (unsigned int i = 0; i < n; i++)
+        t_result += fabs(a[i] - b[i]);
+    return t_result;
+}
+
+#endif
+
+double behavior_distance(BehaviorDistance a_Distance, const double* a, const double* b, unsigned int a_Dimension)
+{
+    switch (a_Distance)
+    {
+    case MANHATTAN_DISTANCE:
+        return sum_absolute_differences(a, b, a_Dimension);
+    case EUCLIDEAN_DISTANCE:
+    default:
+        return sqrt(sum_squared_differences(a, b, a_Dimension));
+    }
+}
+
+
+BehaviorStore::BehaviorStore(unsigned int a_Dimension, BehaviorDistance a_Distance):
+    m_Dimension(a_Dimension), m_Distance(a_Distance)
+{
+    ASSERT(a_Dimension > 0);
+}
+
+void BehaviorStore::Resize(unsigned int a_Size)
+{
+    m_Data.resize(static_cast<size_t>(a_Size) * m_Dimension, 0.0);
+}
+
+unsigned int BehaviorStore::CopyRow(unsigned int a_Idx)
+{
+    unsigned int t_idx = Size();
+    Resize(t_idx + 1);
+    std::copy(Row(a_Idx), Row(a_Idx) + m_Dimension, Row(t_idx));
+    return t_idx;
+}
+
+void BehaviorStore::SetRow(unsigned int a_Idx, const PhenotypeBehavior& a_Behavior)
+{
+    double* t_row = Row(a_Idx);
+    unsigned int t_count = 0;
+    for (unsigned int i = 0; i < a_Behavior.m_Data.size(); i++)
+    {
+        ASSERT(t_count + a_Behavior.m_Data[i].size() <= m_Dimension);
+        std::copy(a_Behavior.m_Data[i].begin(), a_Behavior.m_Data[i].end(), t_row + t_count);
+        t_count += static_cast<unsigned int>(a_Behavior.m_Data[i].size());
+    }
+    ASSERT(t_count == m_Dimension);
+}
+
+void BehaviorStore::Distances(const double* a_Query, unsigned int a_Begin, unsigned int a_End, double* a_Out) const
+{
+    for (unsigned int i = a_Begin; i < a_End; i++)
+    {
+        a_Out[i - a_Begin] = Distance(a_Query, Row(i));
+    }
+}
+
+void BehaviorStore::FindNearest(const double* a_Query, unsigned int a_Begin, unsigned int a_End, unsigned int a_K,
+                                std::vector< std::pair<double, int> >& a_Nearest) const
+{
+    if (a_End <= a_Begin)
+        return;
+
+    std::vector<double> t_distances(a_End - a_Begin);
+    Distances(a_Query, a_Begin, a_End, &t_distances[0]);
+
+    std::vector< std::pair<double, int> > t_rows(t_distances.size());
+    for (unsigned int i = 0; i < t_distances.size(); i++)
+    {
+        t_rows[i] = std::make_pair(t_distances[i], static_cast<int>(a_Begin + i));
+    }
+
+    unsigned int t_count = std::min(a_K, a_End - a_Begin);
+    std::partial_sort(t_rows.begin(), t_rows.begin() + t_count, t_rows.end());
+    a_Nearest.insert(a_Nearest.end(), t_rows.begin(), t_rows.begin() + t_count);
+}
+
+} // namespace NEAT
@@ -0,0 +1,100 @@
+#ifndef _BEHAVIORSTORE_H
+#define _BEHAVIORSTORE_H
+
+///////////////////////////////////////////////////////////////////////////////////////////
+//    MultiNEAT - Python/C++ NeuroEvolution of Augmenting Topologies Library
+//
+//    Copyright (C) 2012 Peter Chervenski
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public License
+//    along with this program.  If not, see < http://www.gnu.org/licenses/ >.
+//
+//    Contact info:
+//
+//    Peter Chervenski < spookey@abv.bg >
+//    Shane Ryan < shane.mcdonald.ryan@gmail.com >
+///////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+// File:        BehaviorStore.h
+// Description: Fixed size behaviors in one matrix, with built-in distances.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+#include <utility>
+#include "PhenotypeBehavior.h"
+
+namespace NEAT
+{
+
+enum BehaviorDistance
+{
+    EUCLIDEAN_DISTANCE,
+    MANHATTAN_DISTANCE
+};
+
+// The distance between two behaviors of a_Dimension values (SSE2, or AVX2 when compiled with -mavx2,
+// with a scalar fallback). It is symmetric and the distance of a behavior to itself is 0.
+double behavior_distance(BehaviorDistance a_Distance, const double* a, const double* b, unsigned int a_Dimension);
+
+// Behaviors of a fixed number of values, kept as the rows of one row-major matrix.
+// The distances are computed by the kernels instead of PhenotypeBehavior::Distance_To().
+// Used by the novelty search when Population::InitBehaviorStore() was called.
+class BehaviorStore
+{
+    unsigned int m_Dimension;
+    BehaviorDistance m_Distance;
+    std::vector<double> m_Data;
+
+public:
+    BehaviorStore(unsigned int a_Dimension, BehaviorDistance a_Distance);
+
+    unsigned int Dimension() const { return m_Dimension; }
+    BehaviorDistance GetDistance() const { return m_Distance; }
+    unsigned int Size() const { return static_cast<unsigned int>(m_Data.size() / m_Dimension); }
+
+    double* Row(unsigned int a_Idx) { return &m_Data[static_cast<size_t>(a_Idx) * m_Dimension]; }
+    const double* Row(unsigned int a_Idx) const { return &m_Data[static_cast<size_t>(a_Idx) * m_Dimension]; }
+
+    // Changes the number of rows, new rows are zero
+    void Resize(unsigned int a_Size);
+
+    // Appends a copy of a row and returns its index
+    unsigned int CopyRow(unsigned int a_Idx);
+
+    // Copies the m_Data of a behavior to a row, row by row.
+    // It must have Dimension() values in total.
+    void SetRow(unsigned int a_Idx, const PhenotypeBehavior& a_Behavior);
+
+    double Distance(const double* a, const double* b) const
+    {
+        return behavior_distance(m_Distance, a, b, m_Dimension);
+    }
+
+    double Distance(unsigned int a_Row1, unsigned int a_Row2) const
+    {
+        return Distance(Row(a_Row1), Row(a_Row2));
+    }
+
+    // Writes the distances from a_Query to the rows [a_Begin, a_End) to a_Out
+    void Distances(const double* a_Query, unsigned int a_Begin, unsigned int a_End, double* a_Out) const;
+
+    // Appends to a_Nearest the a_K nearest rows to a_Query in [a_Begin, a_End)
+    // (all of them if there are fewer) as (distance, row), smaller first
+    void FindNearest(const double* a_Query, unsigned int a_Begin, unsigned int a_End, unsigned int a_K,
+                     std::vector< std::pair<double, int> >& a_Nearest) const;
+};
+
+} // namespace NEAT
+
+#endif
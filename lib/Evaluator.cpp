@@ -0,0 +1,82 @@
+///////////////////////////////////////////////////////////////////////////////////////////
+//    MultiNEAT - Python/C++ NeuroEvolution of Augmenting Topologies Library
+//
+//    Copyright (C) 2012 Peter Chervenski
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public License
+//    along with this program.  If not, see < http://www.gnu.org/licenses/ >.
+//
+//    Contact info:
+//
+//    Peter Chervenski < spookey@abv.bg >
+//    Shane Ryan < shane.mcdonald.ryan@gmail.com >
+///////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+// File:        Evaluator.cpp
+// Description: Implementation of the parallel evaluator.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Evaluator.h"
+
+namespace NEAT
+{
+
+ParallelEvaluator::ParallelEvaluator(unsigned int a_NumThreads):
+    m_Pool(a_NumThreads)
+{
+}
+
+void ParallelEvaluator::Evaluate(std::vector<Genome*>& a_Genomes, const FitnessFunction& a_Fitness)
+{
+    m_Pool.ParallelFor(static_cast<unsigned int>(a_Genomes.size()), [&](unsigned int i)
+    {
+        Genome& t_genome = *a_Genomes[i];
+
+        NeuralNetwork t_net;
+        t_genome.BuildPhenotype(t_net);
+
+        // each genome is touched by one thread only
+        t_genome.SetFitness(a_Fitness(t_net, t_genome));
+        t_genome.SetEvaluated();
+    });
+}
+
+void ParallelEvaluator::Evaluate(Population& a_Pop, const FitnessFunction& a_Fitness, bool a_OnlyNew)
+{
+    std::vector<Genome*> t_genomes;
+    for (unsigned int i = 0; i < a_Pop.m_Species.size(); i++)
+    {
+        for (unsigned int j = 0; j < a_Pop.m_Species[i].m_Individuals.size(); j++)
+        {
+            Genome& t_genome = a_Pop.m_Species[i].m_Individuals[j];
+            if (a_OnlyNew && t_genome.IsEvaluated())
+                continue;
+
+            t_genomes.push_back(&t_genome);
+        }
+    }
+
+    Evaluate(t_genomes, a_Fitness);
+}
+
+void ParallelEvaluator::Evaluate(Population& a_Pop, Evaluator& a_Evaluator, bool a_OnlyNew)
+{
+    FitnessFunction t_fitness = [&a_Evaluator](NeuralNetwork& a_Net, const Genome& a_Genome)
+    {
+        return a_Evaluator.Evaluate(a_Net, a_Genome);
+    };
+    Evaluate(a_Pop, t_fitness, a_OnlyNew);
+}
+
+} // namespace NEAT
@@ -0,0 +1,82 @@
+#ifndef _EVALUATOR_H
+#define _EVALUATOR_H
+
+///////////////////////////////////////////////////////////////////////////////////////////
+//    MultiNEAT - Python/C++ NeuroEvolution of Augmenting Topologies Library
+//
+//    Copyright (C) 2012 Peter Chervenski
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public License
+//    along with this program.  If not, see < http://www.gnu.org/licenses/ >.
+//
+//    Contact info:
+//
+//    Peter Chervenski < spookey@abv.bg >
+//    Shane Ryan < shane.mcdonald.ryan@gmail.com >
+///////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+// File:        Evaluator.h
+// Description: Parallel evaluation of the genomes in a population.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+#include <functional>
+
+#include "NeuralNetwork.h"
+#include "Genome.h"
+#include "Population.h"
+#include "ThreadPool.h"
+
+namespace NEAT
+{
+
+// Returns the fitness of a genome given its phenotype.
+// Called from several threads at once, so it must be thread-safe.
+typedef std::function<double (NeuralNetwork& a_Net, const Genome& a_Genome)> FitnessFunction;
+
+// Derive from this when the evaluation needs its own state (a simulator, a dataset, ..).
+// Evaluate() is called from several threads at once, so it must be thread-safe.
+class Evaluator
+{
+public:
+    virtual ~Evaluator() {}
+    virtual double Evaluate(NeuralNetwork& a_Net, const Genome& a_Genome) = 0;
+};
+
+class ParallelEvaluator
+{
+    ThreadPool m_Pool;
+
+public:
+
+    // 0 threads means as many as the hardware supports
+    ParallelEvaluator(unsigned int a_NumThreads = 0);
+
+    // Builds the phenotype (Genome::BuildPhenotype) of every genome in every species
+    // and evaluates it on the thread pool. The fitness is written back and the genomes
+    // are marked as evaluated, so Population::Epoch() can be called right after.
+    // If a_OnlyNew is true, genomes that are already evaluated are skipped.
+    void Evaluate(Population& a_Pop, const FitnessFunction& a_Fitness, bool a_OnlyNew = false);
+    void Evaluate(Population& a_Pop, Evaluator& a_Evaluator, bool a_OnlyNew = false);
+
+    // The same for any list of genomes
+    void Evaluate(std::vector<Genome*>& a_Genomes, const FitnessFunction& a_Fitness);
+
+    unsigned int NumThreads() const { return m_Pool.NumThreads(); }
+    ThreadPool& GetPool() { return m_Pool; }
+};
+
+} // namespace NEAT
+
+#endif
@@ -2,15 +2,15 @@
 #include "NeuralNetwork.h"
 #include "Parameters.h"
 #include "Genes.h"
+#include "ThreadPool.h"
+#include <atomic>
+#include <unordered_set>
 
 
 
 using namespace NEAT;
 
 EvolvableSubstrate::EvolvableSubstrate(Parameters const & p, boost::python::list const &a_inputs, boost::python::list const &a_outputs):
-    hiddenInsertIndex(0.0, 0.0, 1, 0),
-    outputInsertIndex(0.0, 0.0, 1, 0),
-    inputInsertIndex(0.0, 0.0, 1, 0),
     parameters(p)
 {
 
@@ -44,103 +44,271 @@ EvolvableSubstrate::EvolvableSubstrate(Parameters const & p, boost::python::list
     assert(outputInsertIndex.size() == out);
 }
 
-EvolvableSubstrate::QuadPoint EvolvableSubstrate::QuadTreeInitialisation(float a, float b, bool outgoing){
-    QuadPoint root = QuadPoint(0.0f, 0.0f, 1.0f, 1); //x, y, width, level
-    auto queue = std::deque<QuadPoint*>();
-    queue.push_back(&root);
+void EvolvableSubstrate::QuadTreeInitialisation(CPPNContext & context, float a, float b, bool outgoing){
+    std::vector<QuadPoint> & tree = context.tree;
+    tree.clear();
+    tree.push_back(QuadPoint(0.0f, 0.0f, 1.0f, 1)); //x, y, width, level
 
-    while (!queue.empty())
+    std::vector<uint> level;
+    std::vector<uint> next_level;
+    std::vector<CPPNQuery> queries;
+    std::vector<double> values;
+    level.push_back(0);
+
+    // Expand breadth-first one whole level at a time,
+    // so the children of the level can be sent to the CPPN in one batch
+    while (!level.empty())
     {
-        QuadPoint * p = queue.front();//dequeue
-        queue.pop_front();
+        queries.clear();
+        for (uint i : level)
+        {
+            // Divide into sub-regions and assign children to parent
+            const QuadPoint p = tree[i]; // tree may reallocate below
+            tree[i].first_child = tree.size();
+            tree.push_back(QuadPoint(p.x - p.width / 2, p.y - p.width / 2, p.width / 2, p.level + 1));
+            tree.push_back(QuadPoint(p.x - p.width / 2, p.y + p.width / 2, p.width / 2, p.level + 1));
+            tree.push_back(QuadPoint(p.x + p.width / 2, p.y - p.width / 2, p.width / 2, p.level + 1));
+            tree.push_back(QuadPoint(p.x + p.width / 2, p.y + p.width / 2, p.width / 2, p.level + 1));
+
+            for (uint c = tree[i].first_child; c < tree.size(); c++)
+            {
+                if (outgoing) // Querying connection from input or hidden node
+                {
+                    queries.emplace_back(a, b, tree[c].x, tree[c].y); // Outgoing connectivity pattern
+                }
+                else // Querying connection to output node
+                {
+                    queries.emplace_back(tree[c].x, tree[c].y, a, b); // Incoming connectivity pattern
+                }
+            }
+        }
 
-        // Divide into sub-regions and assign children to parent
-        p->childs.push_back(QuadPoint(p->x - p->width / 2, p->y - p->width / 2, p->width / 2, p->level + 1));
-        p->childs.push_back(QuadPoint(p->x - p->width / 2, p->y + p->width / 2, p->width / 2, p->level + 1));
-        p->childs.push_back(QuadPoint(p->x + p->width / 2, p->y - p->width / 2, p->width / 2, p->level + 1));
-        p->childs.push_back(QuadPoint(p->x + p->width / 2, p->y + p->width / 2, p->width / 2, p->level + 1));
+        queryCPPNBatch(context, queries, values);
 
-        for (auto & c : p->childs)
+        next_level.clear();
+        size_t q = 0;
+        for (uint i : level)
         {
-            if (outgoing) // Querying connection from input or hidden node
+            // it was a leaf until now
+            QuadPoint & p = tree[i];
+            p.sum = 0.0;
+            p.sumsq = 0.0;
+            p.count = 0;
+
+            for (uint c = p.first_child; c < p.first_child + 4u; c++)
             {
-                c.w = queryCPPN(a, b, c.x, c.y); // Outgoing connectivity pattern
+                QuadPoint & child = tree[c];
+                child.w = values[q++];
+                child.sum = child.w;
+                child.sumsq = (double)child.w * child.w;
+                child.count = 1;
+
+                p.sum += child.sum;
+                p.sumsq += child.sumsq;
+                p.count += child.count;
             }
-            else // Querying connection to output node
+
+            // Divide until initial resolution or if variance is still high
+            if (p.level < parameters.InitialDepth || (p.level < parameters.MaximumDepth && variance(p) > parameters.DivisionThreshold))
             {
-                c.w = queryCPPN(c.x, c.y, a, b); // Incoming connectivity pattern
+                for (uint c = p.first_child; c < p.first_child + 4u; c++)
+                {
+                    next_level.push_back(c);
+                }
             }
         }
 
-        // Divide until initial resolution or if variance is still high
-        if (p->level < parameters.InitialDepth || (p->level < parameters.MaximumDepth && variance((*p)) > parameters.DivisionThreshold))
+        level.swap(next_level);
+    }
+
+    // The sums above were taken when the children were still leaves.
+    // Redo them bottom-up, the children always come after their parent.
+    for (size_t i = tree.size(); i-- > 0;)
+    {
+        QuadPoint & p = tree[i];
+        if (p.first_child < 0)
         {
-            for (QuadPoint & c : p->childs)
-            {
-                queue.push_back(&c);
-            }
+            continue;
+        }
+
+        p.sum = 0.0;
+        p.sumsq = 0.0;
+        p.count = 0;
+        for (uint c = p.first_child; c < p.first_child + 4u; c++)
+        {
+            p.sum += tree[c].sum;
+            p.sumsq += tree[c].sumsq;
+            p.count += tree[c].count;
         }
     }
-    return root;
 }
 
 void EvolvableSubstrate::setCPPN(NeuralNetwork * net){
     this->cppn = net;
+
+    // compiles the CPPN once, the queries reuse the plan
+    m_cppn_feed_forward = net->IsFeedForward();
+
+    // cached values belong to the previous CPPN
+    m_context.cppn = net;
+    m_context.cache.clear();
+    m_context.hits = 0;
+    m_context.misses = 0;
+    m_workers.clear();
+}
+
+ThreadPool & EvolvableSubstrate::getThreadPool()
+{
+    return EnsureThreadPool(m_thread_pool, parameters.NumThreads);
 }
 
-std::vector<EvolvableSubstrate::TempConnection> EvolvableSubstrate::PruneAndExpress(float a, float b, QuadPoint & node, bool outgoing)
+unsigned long EvolvableSubstrate::getCacheHits() const
+{
+    unsigned long hits = m_context.hits;
+    for (const CPPNContext & w : m_workers)
+    {
+        hits += w.hits;
+    }
+    return hits;
+}
+
+unsigned long EvolvableSubstrate::getCacheMisses() const
+{
+    unsigned long misses = m_context.misses;
+    for (const CPPNContext & w : m_workers)
+    {
+        misses += w.misses;
+    }
+    return misses;
+}
+
+std::vector<EvolvableSubstrate::TempConnection> EvolvableSubstrate::PruneAndExpress(CPPNContext & context, float a, float b, bool outgoing)
 {
     std::vector<TempConnection> temp_connections;
 
     float left = 0.0f, right = 0.0f, top = 0.0f, bottom = 0.0f;
 
-    if (node.childs.size() == 0) return temp_connections;
+    // Which points get tested depends only on the variances, not on the neighbour values,
+    // so the traversal is done first and all the neighbours are queried in one batch
+    const std::vector<QuadPoint> & tree = context.tree;
+    std::vector< std::pair<uint, float> > candidates;
+    collectBandCandidates(tree, 0, candidates);
 
-    // Traverse quadtree depth-first
-    for (QuadPoint & c : node.childs)
+    if (candidates.empty()) return temp_connections;
+
+    std::vector<CPPNQuery> queries;
+    queries.reserve(candidates.size() * 4);
+    for (auto & candidate : candidates)
     {
-        float childVariance = variance(c);
+        const QuadPoint & c = tree[candidate.first];
+        const float width = candidate.second;
 
-        if (childVariance >= parameters.VarianceThreshold)
+        // left, right, top, bottom
+        if (outgoing)
         {
-            for(auto & _tmp_conn: PruneAndExpress(a, b, c, outgoing)){
-                temp_connections.push_back(_tmp_conn);
-            }
+            queries.emplace_back(a, b, c.x - width, c.y);
+            queries.emplace_back(a, b, c.x + width, c.y);
+            queries.emplace_back(a, b, c.x, c.y - width);
+            queries.emplace_back(a, b, c.x, c.y + width);
         }
-        else //this should always happen for at least the leaf nodes because their variance is zero
+        else
+        {
+            queries.emplace_back(c.x - width, c.y, a, b);
+            queries.emplace_back(c.x + width, c.y, a, b);
+            queries.emplace_back(c.x, c.y - width, a, b);
+            queries.emplace_back(c.x, c.y + width, a, b);
+        }
+    }
+
+    std::vector<double> values;
+    queryCPPNBatch(context, queries, values);
+
+    for (size_t i = 0; i < candidates.size(); i++)
+    {
+        const QuadPoint & c = tree[candidates[i].first];
+
+        // Determine if point is in a band by checking neighbor CPPN values
+        left = std::fabs(c.w - values[i * 4]);
+        right = std::fabs(c.w - values[i * 4 + 1]);
+        top = std::fabs(c.w - values[i * 4 + 2]);
+        bottom = std::fabs(c.w - values[i * 4 + 3]);
+
+        if (std::max(std::min(top, bottom), std::min(left, right)) > parameters.BandingThreshold)
         {
-            // Determine if point is in a band by checking neighbor CPPN values
             if (outgoing)
             {
-                left = std::fabs(c.w - queryCPPN(a, b, c.x - node.width, c.y));
-                right = std::fabs(c.w - queryCPPN(a, b, c.x + node.width, c.y));
-                top = std::fabs(c.w - queryCPPN(a, b, c.x, c.y - node.width));
-                bottom = std::fabs(c.w - queryCPPN(a, b, c.x, c.y + node.width));
+                temp_connections.emplace_back(a, b, c.x, c.y, c.w);
             }
             else
             {
-                left = std::fabs(c.w - queryCPPN(c.x - node.width, c.y, a, b));
-                right = std::fabs(c.w - queryCPPN(c.x + node.width, c.y, a, b));
-                top = std::fabs(c.w - queryCPPN(c.x, c.y - node.width, a, b));
-                bottom = std::fabs(c.w - queryCPPN(c.x, c.y + node.width, a, b));
+                temp_connections.emplace_back(c.x, c.y, a, b, c.w);
             }
+        }
+    }
 
-            if (std::max(std::min(top, bottom), std::min(left, right)) > parameters.BandingThreshold)
-            {
-                if (outgoing)
-                {
-                    temp_connections.emplace_back(a, b, c.x, c.y, c.w);
-                }
-                else
-                {
-                    temp_connections.emplace_back(c.x, c.y, a, b, c.w);
-                }
-            }
+    return temp_connections;
+}
+
+void EvolvableSubstrate::collectBandCandidates(const std::vector<QuadPoint> & tree, uint node, std::vector< std::pair<uint, float> > & candidates)
+{
+    const QuadPoint & p = tree[node];
+    if (p.first_child < 0)
+    {
+        return;
+    }
 
+    // Traverse quadtree depth-first
+    for (uint c = p.first_child; c < p.first_child + 4u; c++)
+    {
+        if (variance(tree[c]) >= parameters.VarianceThreshold)
+        {
+            collectBandCandidates(tree, c, candidates);
+        }
+        else //this should always happen for at least the leaf nodes because their variance is zero
+        {
+            candidates.emplace_back(c, p.width);
         }
     }
+}
 
-    return temp_connections;
+void EvolvableSubstrate::exploreNodes(const std::vector<PointD> & points, bool outgoing, std::vector< std::vector<TempConnection> > & connections)
+{
+    connections.clear();
+    connections.resize(points.size());
+
+    ThreadPool & pool = getThreadPool();
+    const unsigned int num_jobs = static_cast<unsigned int>(std::min<size_t>(pool.NumThreads(), points.size()));
+
+    // a recurrent CPPN depends on the order of the queries, it stays on this thread
+    if (!m_cppn_feed_forward || num_jobs < 2)
+    {
+        for (size_t i = 0; i < points.size(); i++)
+        {
+            QuadTreeInitialisation(m_context, points[i].X, points[i].Y, outgoing);
+            connections[i] = PruneAndExpress(m_context, points[i].X, points[i].Y, outgoing);
+        }
+        return;
+    }
+
+    while (m_workers.size() < num_jobs)
+    {
+        m_workers.emplace_back();
+        m_workers.back().own_cppn = std::make_shared<NeuralNetwork>(*cppn);
+        m_workers.back().cppn = m_workers.back().own_cppn.get();
+    }
+
+    // Each job has its own context and takes the next node until there are none left.
+    // connections[i] depends only on points[i], so how the nodes get split doesn't matter.
+    std::atomic<size_t> next(0);
+    pool.ParallelFor(num_jobs, [&](unsigned int j)
+    {
+        CPPNContext & context = m_workers[j];
+        for (size_t i = next++; i < points.size(); i = next++)
+        {
+            QuadTreeInitialisation(context, points[i].X, points[i].Y, outgoing);
+            connections[i] = PruneAndExpress(context, points[i].X, points[i].Y, outgoing);
+        }
+    });
 }
 
 void EvolvableSubstrate::clearHidden(){
@@ -153,21 +321,31 @@ void EvolvableSubstrate::generateSubstrate(NeuralNetwork _cppn)
     setCPPN(&_cppn);
     this->clearHidden();
     assert(hiddenInsertIndex.checkSize());
-    std::vector<TempConnection> tempConnections;
+    std::vector<PointD> points;
+    std::vector< std::vector<TempConnection> > tempConnections;
     uint innovationCounter = 0;
 
-    //CONNECTIONS DIRECTLY FROM INPUT NODES
-    for(auto it=inputInsertIndex.begin(); it!=inputInsertIndex.end();it++)
+    // (source, target) of the connections made so far, instead of searching m_connections
+    std::unordered_set<unsigned long long> connected;
+    auto connectionKey = [](unsigned long long source, unsigned long long target)
     {
-        const PointD & input = *it;
-        const uint sourceIndex = (*it).data;
-        // Analyze outgoing connectivity pattern from this input
-        QuadPoint root = QuadTreeInitialisation(input.X, input.Y, true);
+        return (source << 32) | target;
+    };
+
+    // The quadtrees of all the nodes of a stage are explored first (in parallel if possible),
+    // then the connections are added in the order of the nodes, so the ids don't depend on the threads
+
+    //CONNECTIONS DIRECTLY FROM INPUT NODES
+    points.assign(inputInsertIndex.begin(), inputInsertIndex.end());
 
-        // Traverse quadtree and add connections to list
-        tempConnections = PruneAndExpress(input.X, input.Y, root, true);
+    // Analyze outgoing connectivity pattern from the inputs
+    exploreNodes(points, true, tempConnections);
 
-        for (TempConnection & p : tempConnections)
+    for (size_t i = 0; i < points.size(); i++)
+    {
+        const uint sourceIndex = points[i].data;
+
+        for (TempConnection & p : tempConnections[i])
         {
             PointD newp = PointD(p.x2, p.y2);
             uint targetIndex;
@@ -186,6 +364,7 @@ void EvolvableSubstrate::generateSubstrate(NeuralNetwork _cppn)
                 }
                 if(targetIndex!=sourceIndex){
                 m_connections.push_back(LinkGene(sourceIndex, targetIndex, innovationCounter++, p.weight));
+                connected.insert(connectionKey(sourceIndex, targetIndex));
                 }
             }
         }
@@ -194,19 +373,22 @@ void EvolvableSubstrate::generateSubstrate(NeuralNetwork _cppn)
     tempConnections.clear();
 
     //HIDDEN TO HIDDEN NEURONS
-    SQuadPoint<PointD> unexploredHiddenNodes = getHiddenPoints();
+    // Hidden nodes are only added and the index keeps them in insertion order,
+    // so the unexplored ones are the ones after the first 'explored'
+    size_t explored = 0;
 
     for (uint step = 0; step < this->parameters.ESIterations; step++)
     {
-        for (auto & hiddenP: unexploredHiddenNodes)
-        {
-            QuadPoint root = QuadTreeInitialisation(hiddenP.X, hiddenP.Y, true);
+        points.assign(hiddenInsertIndex.begin() + explored, hiddenInsertIndex.end());
+        explored = hiddenInsertIndex.size();
 
-            tempConnections = PruneAndExpress(hiddenP.X, hiddenP.Y, root, true);
+        exploreNodes(points, true, tempConnections);
 
-            const uint sourceIndex = hiddenP.data;
+        for (size_t i = 0; i < points.size(); i++)
+        {
+            const uint sourceIndex = points[i].data;
 
-            for (TempConnection const & p: tempConnections)
+            for (TempConnection const & p: tempConnections[i])
             {
                 PointD newp = PointD(p.x2, p.y2);
 
@@ -223,43 +405,30 @@ void EvolvableSubstrate::generateSubstrate(NeuralNetwork _cppn)
                     }
 
                     if(targetIndex!=sourceIndex){
-                        if ((step == 0) ? true : (connectionCount(sourceIndex, targetIndex) == 0)){
+                        if ((step == 0) ? true : (connected.count(connectionKey(sourceIndex, targetIndex)) == 0)){
                             m_connections.emplace_back(sourceIndex, targetIndex, innovationCounter++, p.weight);
+                            connected.insert(connectionKey(sourceIndex, targetIndex));
                         }
                     }
                 }
             }
         }
 
-        SQuadPoint<PointD> temp = getHiddenPoints();
-
-        // Remove the just explored nodes
-        for (auto f: unexploredHiddenNodes){
-            temp.erase(f);
-            assert(hiddenInsertIndex.find(f) != hiddenInsertIndex.end());
-        }
-
-        unexploredHiddenNodes = std::move(temp);
-
     }
 
     tempConnections.clear();
 
     // CONNECT HIDDEN TO OUTPUT
-    uint _vv=0;
-    for(auto it=outputInsertIndex.begin(); it!=outputInsertIndex.end();it++)
-    {
-
-        const PointD & outputPos = *it;
-        const uint targetIndex = (*it).data;
+    points.assign(outputInsertIndex.begin(), outputInsertIndex.end());
 
-        // Analyze incoming connectivity pattern to this output
-        QuadPoint root = QuadTreeInitialisation(outputPos.X, outputPos.Y, false);
+    // Analyze incoming connectivity pattern to the outputs
+    exploreNodes(points, false, tempConnections);
 
-        tempConnections = PruneAndExpress(outputPos.X, outputPos.Y, root, false);
-        _vv++;
+    for (size_t i = 0; i < points.size(); i++)
+    {
+        const uint targetIndex = points[i].data;
 
-        for (const TempConnection &  t: tempConnections)
+        for (const TempConnection &  t: tempConnections[i])
         {
             PointD source(t.x1, t.y1);
 
@@ -269,7 +438,7 @@ void EvolvableSubstrate::generateSubstrate(NeuralNetwork _cppn)
             New nodes not created here because all the hidden nodes that are
                 connected to an input/hidden node are already expressed.
             */
-            if (hidden_it != outputInsertIndex.end()){  //only connect if hidden neuron already exists
+            if (hidden_it != hiddenInsertIndex.end()){  //only connect if hidden neuron already exists
                 uint sourceIndex = (*hidden_it).data;
                 if(targetIndex!=sourceIndex){
                     m_connections.push_back(LinkGene(sourceIndex, targetIndex, innovationCounter++, t.weight));
@@ -285,58 +454,130 @@ void EvolvableSubstrate::generateSubstrate(NeuralNetwork _cppn)
 }
 
 bool EvolvableSubstrate::existNonHidden(PointD & p){
-    auto out = outputInsertIndex.find(p);
-    auto inp = inputInsertIndex.find(p);
-    bool result = true;
-    if(inp == inputInsertIndex.end() && out == outputInsertIndex.end()){
-        result = false;
-    }
-    return result;
+    return inputInsertIndex.contains(p) || outputInsertIndex.contains(p);
 }
 
 bool EvolvableSubstrate::existInput(PointD & p){
-    auto inp = inputInsertIndex.find(p);
-    bool result = true;
-    if(inp == inputInsertIndex.end()){
-        result = false;
-    }
-    return result;
+    return inputInsertIndex.contains(p);
 }
 
 double EvolvableSubstrate::queryCPPN(float x1, float y1, float x2, float y2)
 {
-    std::vector<double> coordinates;
-    coordinates.reserve(5);
-    coordinates.push_back(x1);
-    coordinates.push_back(y1);
-    coordinates.push_back(x2);
-    coordinates.push_back(y2);
-    coordinates.push_back(1.0);  // bias
-
-    cppn->Input(coordinates);
-    cppn->RecursiveActivation();
-    std::vector<double> output = cppn->Output();
-    ASSERT(output.size() == 1);
-    return output[0];
+    return queryCPPN(m_context, x1, y1, x2, y2);
 }
 
-void EvolvableSubstrate::getCPPNValues(std::vector<float> & l, const QuadPoint & p)
+double EvolvableSubstrate::queryCPPN(CPPNContext & context, float x1, float y1, float x2, float y2)
 {
-    if (!p.childs.empty())
+    NeuralNetwork * net = context.cppn;
+
+    if (!m_cppn_feed_forward)
     {
-        for (int i = 0; i < 4; i++)
+        context.misses++;
+
+        std::vector<double> coordinates;
+        coordinates.reserve(5);
+        coordinates.push_back(x1);
+        coordinates.push_back(y1);
+        coordinates.push_back(x2);
+        coordinates.push_back(y2);
+        coordinates.push_back(1.0);  // bias
+
+        net->Input(coordinates);
+        net->RecursiveActivation();
+        std::vector<double> output = net->Output();
+        ASSERT(output.size() == 1);
+        return output[0];
+    }
+
+    CPPNQuery query(x1, y1, x2, y2);
+    auto cached = context.cache.find(query);
+    if (cached != context.cache.end())
+    {
+        context.hits++;
+        return cached->second;
+    }
+    context.misses++;
+
+    ASSERT(net->NumInputs() == 5);
+    ASSERT(net->NumOutputs() == 1);
+    const double coordinates[5] = {x1, y1, x2, y2, 1.0};  // the last one is the bias
+    double output = 0.0;
+    net->ActivateFeedForward(coordinates, &output);
+
+    context.cache.emplace(query, output);
+    return output;
+}
+
+void EvolvableSubstrate::queryCPPNBatch(CPPNContext & context, const std::vector<CPPNQuery> & queries, std::vector<double> & results)
+{
+    results.resize(queries.size());
+
+    // recurrent CPPNs must see the queries one by one, in order
+    if (!m_cppn_feed_forward)
+    {
+        for (size_t i = 0; i < queries.size(); i++)
         {
-            getCPPNValues(l, p.childs[i]);
+            results[i] = queryCPPN(context, queries[i].x1, queries[i].y1, queries[i].x2, queries[i].y2);
         }
+        return;
     }
-    else
+
+    // Find what is not cached yet. A point repeated within the batch is evaluated once,
+    // and counts as a hit after the first time, same as querying one by one.
+    std::unordered_map<CPPNQuery, size_t, CPPNQueryHash> pending;
+    std::vector<size_t> slot(queries.size(), 0);
+    std::vector<bool> cached(queries.size(), false);
+    context.batch_inputs.clear();
+
+    for (size_t i = 0; i < queries.size(); i++)
     {
-        l.push_back(p.w);
+        auto it = context.cache.find(queries[i]);
+        if (it != context.cache.end())
+        {
+            context.hits++;
+            results[i] = it->second;
+            cached[i] = true;
+            continue;
+        }
+
+        auto inserted = pending.emplace(queries[i], pending.size());
+        if (inserted.second)
+        {
+            context.misses++;
+            context.batch_inputs.push_back(queries[i].x1);
+            context.batch_inputs.push_back(queries[i].y1);
+            context.batch_inputs.push_back(queries[i].x2);
+            context.batch_inputs.push_back(queries[i].y2);
+            context.batch_inputs.push_back(1.0);  // bias
+        }
+        else
+        {
+            context.hits++;
+        }
+        slot[i] = inserted.first->second;
+    }
+
+    if (pending.empty()) return;
+
+    ASSERT(context.cppn->NumInputs() == 5);
+    ASSERT(context.cppn->NumOutputs() == 1);
+    context.cppn->ActivateBatch(context.batch_inputs, context.batch_outputs);
+
+    for (auto & p : pending)
+    {
+        context.cache.emplace(p.first, context.batch_outputs[p.second]);
+    }
+    for (size_t i = 0; i < queries.size(); i++)
+    {
+        if (!cached[i])
+        {
+            results[i] = context.batch_outputs[slot[i]];
+        }
     }
 }
 
-SQuadPoint<PointD> EvolvableSubstrate::getHiddenPoints(){
-    SQuadPoint<PointD> result = this->hiddenInsertIndex;
+PointIndex<PointD> EvolvableSubstrate::getHiddenPoints(){
+    PointIndex<PointD> result = this->hiddenInsertIndex;
     return result;
 }
 
@@ -353,7 +594,7 @@ bool EvolvableSubstrate::checkConnections(){
 
 std::vector<PointD> EvolvableSubstrate::checkNeuronID(uint a_id){
     std::vector<PointD> result;
-    std::vector< SQuadPoint<PointD> * > vec = {&inputInsertIndex, &outputInsertIndex, &hiddenInsertIndex};
+    std::vector< PointIndex<PointD> * > vec = {&inputInsertIndex, &outputInsertIndex, &hiddenInsertIndex};
     for(auto & InsertIndex: vec){
         for(auto it=InsertIndex->begin(); it!=InsertIndex->end();it++){
             if((*it).data == a_id){
@@ -379,7 +620,7 @@ uint EvolvableSubstrate::connectionCount(uint source, uint target){
 
 bool EvolvableSubstrate::pointExists(size_t neuronId){
     bool result = false;
-    std::vector< SQuadPoint<PointD> * > vec = {&inputInsertIndex, &outputInsertIndex, &hiddenInsertIndex};
+    std::vector< PointIndex<PointD> * > vec = {&inputInsertIndex, &outputInsertIndex, &hiddenInsertIndex};
     for(auto & InsertIndex: vec){
         for(auto it=InsertIndex->begin(); it!=InsertIndex->end() && !result;it++){
             if((*it).data == neuronId){
@@ -3,19 +3,22 @@
 #include <deque>
 #include <map>
 #include <memory>
+#include <unordered_map>
+#include <string.h>
 #include <math.h>
 #include "Genes.h"
 #include "Assert.h"
 #include "Point.h"
 #include <algorithm>
 #include "SubstrateBase.h"
-#include "QuadTree.h"
+#include "PointIndex.h"
 
 
 namespace NEAT
 {
 
 class NeuralNetwork;
+class ThreadPool;
 
 
 class EvolvableSubstrate: public SubstrateBase
@@ -24,9 +27,9 @@ private:
     EvolvableSubstrate()=delete;
 
 public:
-    SQuadPoint<PointD> hiddenInsertIndex;
-    SQuadPoint<PointD> outputInsertIndex;
-    SQuadPoint<PointD> inputInsertIndex;
+    PointIndex<PointD> hiddenInsertIndex;
+    PointIndex<PointD> outputInsertIndex;
+    PointIndex<PointD> inputInsertIndex;
     NEAT::ActivationFunction m_hidden_nodes_activation = NEAT::UNSIGNED_SIGMOID;
     NEAT::ActivationFunction m_output_nodes_activation = NEAT::UNSIGNED_SIGMOID;
     std::vector<LinkGene> m_connections;
@@ -35,14 +38,21 @@ public:
 
     NeuralNetwork * cppn;
 
+    // A node of a quadtree. The nodes live in one vector (see CPPNContext::tree),
+    // the four children of a node are next to each other in it.
     struct QuadPoint
     {
         float x, y;
         float w; //stores the CPPN value
         float width; //width of this quadtree square
-        std::vector<QuadPoint> childs;
+        int first_child; //index of the first child in the tree, -1 for a leaf
         uint level; //the level in the quadtree
 
+        // sum, sum of squares and number of the CPPN values of the leaves under this node,
+        // so the variance of a region doesn't need to visit them
+        double sum, sumsq;
+        uint count;
+
         QuadPoint(float _x, float _y, float _w, int _level)
         {
             level = _level;
@@ -50,7 +60,10 @@ public:
             x = _x;
             y = _y;
             width = _w;
-            childs = std::vector<QuadPoint>();
+            first_child = -1;
+            sum = 0.0;
+            sumsq = 0.0;
+            count = 0;
         }
         
     };
@@ -66,31 +79,112 @@ public:
         }
     };
 
+    // Coordinates of one CPPN query, as the floats queryCPPN() gets them.
+    // The quadtree coordinates are dyadic fractions, so the same point always
+    // comes out as the same float and can be compared exactly.
+    struct CPPNQuery
+    {
+        float x1, y1, x2, y2;
+
+        CPPNQuery(float _x1, float _y1, float _x2, float _y2):
+        x1 (_x1 + 0.0f), y1 (_y1 + 0.0f), x2(_x2 + 0.0f), y2(_y2 + 0.0f) // -0.0 becomes 0.0
+        {
+        }
+
+        bool operator==(const CPPNQuery & other) const
+        {
+            return x1 == other.x1 && y1 == other.y1 && x2 == other.x2 && y2 == other.y2;
+        }
+    };
+
+    struct CPPNQueryHash
+    {
+        size_t operator()(const CPPNQuery & q) const
+        {
+            uint32_t bits[4];
+            memcpy(bits, &q, sizeof(bits));
+            uint64_t h = 14695981039346656037ULL;
+            for (int i = 0; i < 4; i++)
+            {
+                h = (h ^ bits[i]) * 1099511628211ULL;
+            }
+            return static_cast<size_t>(h);
+        }
+    };
+
+    // What is needed to query the CPPN from one thread. Every worker has its own copy
+    // of the network, the compiled plan keeps its activation buffers there.
+    struct CPPNContext
+    {
+        NeuralNetwork * cppn = nullptr;
+        std::shared_ptr<NeuralNetwork> own_cppn; // the worker's copy
+
+        // CPPN outputs already computed in this generateSubstrate() call
+        // Only used for feed-forward CPPNs
+        std::unordered_map<CPPNQuery, double, CPPNQueryHash> cache;
+
+        // the quadtree being explored, cleared for every node of the substrate
+        // so the memory is allocated only once
+        std::vector<QuadPoint> tree;
+
+        // buffers for the batched CPPN queries
+        std::vector<double> batch_inputs;
+        std::vector<double> batch_outputs;
+        unsigned long hits = 0;
+        unsigned long misses = 0;
+    };
+
 private:
 
     const Parameters & parameters;
 
+    // A feed-forward CPPN is evaluated in one sweep over its compiled plan.
+    // Recurrent ones need RecursiveActivation(), their output also depends on the previous queries.
+    bool m_cppn_feed_forward = false;
+
+    // used by queryCPPN() and when the substrate is generated on one thread
+    CPPNContext m_context;
+
+    // one per job when the nodes are explored in parallel, made on demand for the current CPPN
+    std::vector<CPPNContext> m_workers;
+
+    // created on demand with parameters.NumThreads threads
+    std::shared_ptr<ThreadPool> m_thread_pool;
+    ThreadPool & getThreadPool();
+
     /*
      * Input: Coordinates of source (outgoing = true) or target node (outgoing = false) at (a,b)
-     * Output: Quadtree, in which each quadnode at (x,y) stores CPPN activation level for its
-     *         position. The initialized quadtree is used in the PruningAndExtraction phase to
-     *         generate the actual ANN connections.
+     * Output: Quadtree in context.tree (the root is the first node), in which each quadnode at (x,y)
+     *         stores CPPN activation level for its position. The initialized quadtree is used in the
+     *         PruningAndExtraction phase to generate the actual ANN connections.
      */
-    QuadPoint QuadTreeInitialisation(float a, float b, bool outgoing);
+    void QuadTreeInitialisation(CPPNContext & context, float a, float b, bool outgoing);
 
     /*
-     * Input : Coordinates of source (outgoing = true) or target node (outgoing = false) at (a,b) and initialized quadtree p->
+     * Input : Coordinates of source (outgoing = true) or target node (outgoing = false) at (a,b) and initialized quadtree context.tree
      * Output: Adds the connections that are in bands of the two-dimensional cross-section of the
      *         hypercube containing the source or target node to the connections list.
      *
      */
 
-    std::vector<TempConnection> PruneAndExpress(float a, float b, QuadPoint & node, bool outgoing);
+    std::vector<TempConnection> PruneAndExpress(CPPNContext & context, float a, float b, bool outgoing);
+
+    // Collects the points PruneAndExpress() tests for being in a band, in depth-first order,
+    // as indices in the tree together with the width of their parent (the distance to the neighbours probed)
+    void collectBandCandidates(const std::vector<QuadPoint> & tree, uint node, std::vector< std::pair<uint, float> > & candidates);
+
+    /*
+     * Runs QuadTreeInitialisation and PruneAndExpress for every node in points, connections[i]
+     * gets the connections found for points[i]. The nodes are independent of each other, with
+     * a feed-forward CPPN they are explored in parallel and the result is the same as on one thread.
+     */
+    void exploreNodes(const std::vector<PointD> & points, bool outgoing, std::vector< std::vector<TempConnection> > & connections);
 
-    //Collect the CPPN values stored in a given quadtree p
-    //Used to estimate the variance in a certain region in space
+    double queryCPPN(CPPNContext & context, float x1, float y1, float x2, float y2);
 
-    void getCPPNValues(std::vector<float> & l, const QuadPoint &p);
+    // Evaluates all the queries at once, results[i] is the CPPN output for queries[i].
+    // The ones not in the cache go through the CPPN in a single ActivateBatch() call.
+    void queryCPPNBatch(CPPNContext & context, const std::vector<CPPNQuery> & queries, std::vector<double> & results);
 
     void clearHidden();
     bool existNonHidden(PointD & p);
@@ -104,30 +198,24 @@ public:
     //determine the variance of a certain region
     float variance(const QuadPoint & p)
     {
-        if (p.childs.empty())
+        if (p.first_child < 0)
         {
             return 0.0f;
         }
 
-        std::vector<float> l =  std::vector<float>();
-        getCPPNValues(l, p);
-
-        float m = 0.0f, v = 0.0f;
-        for (float f: l)
-        {
-            m += f;
-        }
-        m /= l.size();
-        for (float f: l)
-        {
-            v += (float)(std::pow(f - m, 2));
-        }
-        v /= l.size();
-        return v;
+        double m = p.sum / p.count;
+        double v = p.sumsq / p.count - m * m;
+        return (float)std::max(v, 0.0);
     }
 
     double queryCPPN(float x1, float y1, float x2, float y2);
 
+    // How many CPPN queries the last generateSubstrate() answered from the cache
+    // and how many had to activate the CPPN.
+    // Each worker thread has its own cache, so with more threads there are more misses.
+    unsigned long getCacheHits() const;
+    unsigned long getCacheMisses() const;
+
     /*
      * The main method that generations a list of ANN connections based on the information in the
      * underlying hypercube.
@@ -151,7 +239,7 @@ public:
         return result;
     }
 
-    SQuadPoint<PointD> getHiddenPoints();
+    PointIndex<PointD> getHiddenPoints();
 
     //debug and test functions
 
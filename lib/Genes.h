@@ -145,7 +145,14 @@ public:
     {
     }
 
-    LinkGene()=delete;
+private:
+    // Only used when loading from an archive
+    LinkGene():
+        m_FromNeuronID(0), m_ToNeuronID(0), m_InnovationID(0), m_Weight(0), m_IsRecurrent(false)
+    {
+    }
+
+public:
 
     // assigment operator
     LinkGene& operator =(const LinkGene& a_g)
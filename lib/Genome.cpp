@@ -30,6 +30,7 @@
 
 
 #include <algorithm>
+#include <limits>
 #include <fstream>
 
 #include <math.h>
@@ -72,6 +73,9 @@ Genome::Genome(const Genome& a_G)
     m_Depth       = a_G.m_Depth;
     m_NeuronGenes = a_G.m_NeuronGenes;
     m_LinkGenes   = a_G.m_LinkGenes;
+    m_NeuronIndex = a_G.m_NeuronIndex;
+    m_LinkIndex   = a_G.m_LinkIndex;
+    m_LinkPairIndex = a_G.m_LinkPairIndex;
     m_Fitness     = a_G.m_Fitness;
     m_NumInputs   = a_G.m_NumInputs;
     m_NumOutputs  = a_G.m_NumOutputs;
@@ -91,6 +95,53 @@ Genome& Genome::operator =(const Genome& a_G)
         m_Depth       = a_G.m_Depth;
         m_NeuronGenes = a_G.m_NeuronGenes;
         m_LinkGenes   = a_G.m_LinkGenes;
+        m_NeuronIndex = a_G.m_NeuronIndex;
+        m_LinkIndex   = a_G.m_LinkIndex;
+        m_LinkPairIndex = a_G.m_LinkPairIndex;
+        m_Fitness     = a_G.m_Fitness;
+        m_AdjustedFitness = a_G.m_AdjustedFitness;
+        m_NumInputs   = a_G.m_NumInputs;
+        m_NumOutputs  = a_G.m_NumOutputs;
+        m_OffspringAmount = a_G.m_OffspringAmount;
+        m_Evaluated = a_G.m_Evaluated;
+        m_PhenotypeBehavior = a_G.m_PhenotypeBehavior;
+    }
+
+    return *this;
+}
+
+// move constructor
+Genome::Genome(Genome&& a_G)
+{
+    m_ID          = a_G.m_ID;
+    m_Depth       = a_G.m_Depth;
+    m_NeuronGenes = std::move(a_G.m_NeuronGenes);
+    m_LinkGenes   = std::move(a_G.m_LinkGenes);
+    m_NeuronIndex = std::move(a_G.m_NeuronIndex);
+    m_LinkIndex   = std::move(a_G.m_LinkIndex);
+    m_LinkPairIndex = std::move(a_G.m_LinkPairIndex);
+    m_Fitness     = a_G.m_Fitness;
+    m_NumInputs   = a_G.m_NumInputs;
+    m_NumOutputs  = a_G.m_NumOutputs;
+    m_AdjustedFitness = a_G.m_AdjustedFitness;
+    m_OffspringAmount = a_G.m_OffspringAmount;
+    m_Evaluated = a_G.m_Evaluated;
+    m_PhenotypeBehavior = a_G.m_PhenotypeBehavior;
+}
+
+// move assignment operator
+Genome& Genome::operator =(Genome&& a_G)
+{
+    // self assignment guard
+    if (this != &a_G)
+    {
+        m_ID          = a_G.m_ID;
+        m_Depth       = a_G.m_Depth;
+        m_NeuronGenes = std::move(a_G.m_NeuronGenes);
+        m_LinkGenes   = std::move(a_G.m_LinkGenes);
+        m_NeuronIndex = std::move(a_G.m_NeuronIndex);
+        m_LinkIndex   = std::move(a_G.m_LinkIndex);
+        m_LinkPairIndex = std::move(a_G.m_LinkPairIndex);
         m_Fitness     = a_G.m_Fitness;
         m_AdjustedFitness = a_G.m_AdjustedFitness;
         m_NumInputs   = a_G.m_NumInputs;
@@ -113,6 +164,9 @@ Genome::Genome(Genome& a_G)
         m_Depth       = a_G.m_Depth;
         m_NeuronGenes = a_G.m_NeuronGenes;
         m_LinkGenes   = a_G.m_LinkGenes;
+        m_NeuronIndex = a_G.m_NeuronIndex;
+        m_LinkIndex   = a_G.m_LinkIndex;
+        m_LinkPairIndex = a_G.m_LinkPairIndex;
         m_Fitness     = a_G.m_Fitness;
         m_AdjustedFitness = a_G.m_AdjustedFitness;
         m_NumInputs   = a_G.m_NumInputs;
@@ -145,11 +199,11 @@ Genome::Genome(unsigned int a_ID,
     // The order of the neurons is very important. It is the following: INPUTS, BIAS, OUTPUTS, HIDDEN ... (no limit)
     for(unsigned int i=0; i < (a_NumInputs-1); i++)
     {
-        m_NeuronGenes.push_back( NeuronGene(INPUT, t_nnum, 0.0) );
+        AddNeuronGene( NeuronGene(INPUT, t_nnum, 0.0) );
         t_nnum++;
     }
     // add the bias
-    m_NeuronGenes.push_back( NeuronGene(BIAS, t_nnum, 0.0) );
+    AddNeuronGene( NeuronGene(BIAS, t_nnum, 0.0) );
     t_nnum++;
 
     // now the outputs
@@ -163,7 +217,7 @@ Genome::Genome(unsigned int a_ID,
                       (a_Parameters.MinNeuronBias + a_Parameters.MaxNeuronBias)/2.0f,
                       a_OutputActType );
 
-        m_NeuronGenes.push_back( t_ngene );
+        AddNeuronGene( t_ngene );
         t_nnum++;
     }
 
@@ -182,7 +236,7 @@ Genome::Genome(unsigned int a_ID,
 
             t_ngene.m_SplitY = 0.5;
 
-            m_NeuronGenes.push_back( t_ngene );
+            AddNeuronGene( t_ngene );
             t_nnum++;
         }
 
@@ -195,7 +249,7 @@ Genome::Genome(unsigned int a_ID,
                 {
                     // add the link
                     // created with zero weights. needs future random initialization. !!!!!!!!
-                    m_LinkGenes.push_back( LinkGene(j+1, i+a_NumInputs+a_NumOutputs+1, t_innovnum, 0.0, false) );
+                    AddLinkGene( LinkGene(j+1, i+a_NumInputs+a_NumOutputs+1, t_innovnum, 0.0, false) );
                     t_innovnum++;
                 }
             }
@@ -206,7 +260,7 @@ Genome::Genome(unsigned int a_ID,
                 {
                     // add the link
                     // created with zero weights. needs future random initialization. !!!!!!!!
-                    m_LinkGenes.push_back( LinkGene(j+a_NumInputs+a_NumOutputs+1, i+a_NumInputs+1, t_innovnum, 0.0, false) );
+                    AddLinkGene( LinkGene(j+a_NumInputs+a_NumOutputs+1, i+a_NumInputs+1, t_innovnum, 0.0, false) );
                     t_innovnum++;
                 }
             }
@@ -215,7 +269,7 @@ Genome::Genome(unsigned int a_ID,
             {
                 // add the link
                 // created with zero weights. needs future random initialization. !!!!!!!!
-                m_LinkGenes.push_back( LinkGene(a_NumInputs, i+a_NumInputs+1, t_innovnum, 0.0, false) );
+                AddLinkGene( LinkGene(a_NumInputs, i+a_NumInputs+1, t_innovnum, 0.0, false) );
                 t_innovnum++;
             }
         }
@@ -229,7 +283,7 @@ Genome::Genome(unsigned int a_ID,
                 {
                     // add the link
                     // created with zero weights. needs future random initialization. !!!!!!!!
-                    m_LinkGenes.push_back( LinkGene(j+1, i+a_NumInputs+1, t_innovnum, 0.0, false) );
+                    AddLinkGene( LinkGene(j+1, i+a_NumInputs+1, t_innovnum, 0.0, false) );
                     t_innovnum++;
                 }
             }
@@ -245,9 +299,9 @@ Genome::Genome(unsigned int a_ID,
                 int t_outp_id = a_NumInputs+1 + i;
 
                 // created with zero weights. needs future random initialization. !!!!!!!!
-                m_LinkGenes.push_back( LinkGene(t_inp_id, t_outp_id,  t_innovnum, 0.0, false) );
+                AddLinkGene( LinkGene(t_inp_id, t_outp_id,  t_innovnum, 0.0, false) );
                 t_innovnum++;
-                m_LinkGenes.push_back( LinkGene(t_bias_id, t_outp_id, t_innovnum, 0.0, false) );
+                AddLinkGene( LinkGene(t_bias_id, t_outp_id, t_innovnum, 0.0, false) );
                 t_innovnum++;
             }
         }
@@ -269,15 +323,7 @@ int Genome::GetNeuronIndex(unsigned int a_ID) const
 {
     ASSERT(a_ID > 0);
 
-    for(unsigned int i=0; i < NumNeurons(); i++)
-    {
-        if (m_NeuronGenes[i].ID() == a_ID)
-        {
-            return i;
-        }
-    }
-
-    return -1;
+    return m_NeuronIndex.Find(a_ID);
 }
 
 // A little helper function to find the index of a link, given its innovation ID
@@ -287,15 +333,62 @@ unsigned int Genome::GetLinkIndex(unsigned int a_InnovID) const
     ASSERT(a_InnovID > 0);
     ASSERT(NumLinks() > 0);
 
-    for(unsigned int i=0; i < NumLinks(); i++)
+    return m_LinkIndex.Find(a_InnovID);
+}
+
+
+// Append a gene and update the lookup indices
+void Genome::AddNeuronGene(const NeuronGene& a_Neuron)
+{
+    m_NeuronIndex.Insert(a_Neuron.ID(), NumNeurons());
+    m_NeuronGenes.push_back(a_Neuron);
+}
+
+void Genome::AddLinkGene(const LinkGene& a_Link)
+{
+    m_LinkIndex.Insert(a_Link.InnovationID(), NumLinks());
+    m_LinkPairIndex.Insert(GeneIndex::LinkKey(a_Link.FromNeuronID(), a_Link.ToNeuronID()), NumLinks());
+    m_LinkGenes.push_back(a_Link);
+}
+
+// Erase a gene and update the lookup indices
+void Genome::EraseNeuronGene(unsigned int a_Position)
+{
+    m_NeuronIndex.Erase(a_Position);
+    m_NeuronGenes.erase(m_NeuronGenes.begin() + a_Position);
+}
+
+void Genome::EraseLinkGene(unsigned int a_Position)
+{
+    m_LinkIndex.Erase(a_Position);
+    m_LinkPairIndex.Erase(a_Position);
+    m_LinkGenes.erase(m_LinkGenes.begin() + a_Position);
+}
+
+// Rebuilds the lookup indices from the gene lists
+void Genome::RebuildIndex()
+{
+    m_NeuronIndex.Clear();
+    m_LinkIndex.Clear();
+    m_LinkPairIndex.Clear();
+    m_NeuronIndex.Reserve(NumNeurons());
+    m_LinkIndex.Reserve(NumLinks());
+    m_LinkPairIndex.Reserve(NumLinks());
+
+    for(unsigned int i=0; i<NumNeurons(); i++)
     {
-        if (m_LinkGenes[i].InnovationID() == a_InnovID)
-        {
-            return i;
-        }
+        m_NeuronIndex.Append(m_NeuronGenes[i].ID(), i);
     }
 
-    return -1;
+    for(unsigned int i=0; i<NumLinks(); i++)
+    {
+        m_LinkIndex.Append(m_LinkGenes[i].InnovationID(), i);
+        m_LinkPairIndex.Append(GeneIndex::LinkKey(m_LinkGenes[i].FromNeuronID(), m_LinkGenes[i].ToNeuronID()), i);
+    }
+
+    m_NeuronIndex.Sort();
+    m_LinkIndex.Sort();
+    m_LinkPairIndex.Sort();
 }
 
 
@@ -339,15 +432,7 @@ bool Genome::HasNeuronID(unsigned int a_ID) const
     ASSERT(a_ID > 0);
     ASSERT(NumNeurons() > 0);
 
-    for(unsigned int i=0; i<NumNeurons(); i++)
-    {
-        if (m_NeuronGenes[i].ID() == a_ID)
-        {
-            return true;
-        }
-    }
-
-    return false;
+    return (m_NeuronIndex.Find(a_ID) != -1);
 }
 
 
@@ -356,15 +441,7 @@ bool Genome::HasLink(unsigned int a_n1id, unsigned int a_n2id) const
 {
     ASSERT((a_n1id>0)&&(a_n2id>0));
 
-    for(unsigned int i=0; i<NumLinks(); i++)
-    {
-        if ((m_LinkGenes[i].FromNeuronID() == a_n1id) && (m_LinkGenes[i].ToNeuronID() == a_n2id))
-        {
-            return true;
-        }
-    }
-
-    return false;
+    return (m_LinkPairIndex.Find(GeneIndex::LinkKey(a_n1id, a_n2id)) != -1);
 }
 
 
@@ -373,15 +450,7 @@ bool Genome::HasLinkByInnovID(unsigned int id) const
 {
     ASSERT(id > 0);
 
-    for(unsigned int i=0; i<NumLinks(); i++)
-    {
-        if (m_LinkGenes[i].InnovationID() == id)
-        {
-            return true;
-        }
-    }
-
-    return false;
+    return (m_LinkIndex.Find(id) != -1);
 }
 
 
@@ -517,145 +586,187 @@ void Genome::BuildHyperNEATPhenotype(NeuralNetwork& net, Substrate& subst)
     // Begin querying the CPPN
     // Create the neural network that will represent the CPPN
     NeuralNetwork t_temp_phenotype = buildTempPhenotype(true);
-    t_temp_phenotype.SetInputOutputDimentions(5, 1);
+    t_temp_phenotype.SetInputOutputDimentions(static_cast<unsigned short>(CPPN_numinputs),
+                                              static_cast<unsigned short>(NumOutputs()));
+    const unsigned int t_cppn_outputs = NumOutputs();
     // now loop over every potential connection in the substrate and take its weight
     uint dp = CalculateDepth();
+    // CPPNs without loops can be queried in one pass
+    bool t_feed_forward = t_temp_phenotype.IsFeedForward();
 
-    // only incoming connections, so loop only the hidden and output neurons
-    for(unsigned int i=net.NumInputs(); i<net.m_neurons.size(); i++)
-    {
-        if (subst.m_leaky)
-        {
-            // neuron specific stuff
-            t_temp_phenotype.Flush();
-
-            // Inputs for the generation of time consts and biases across
-            // the nodes in the substrate
-            // We input only the position of the first node and ignore the other one
-
-            std::vector<double> t_inputs;
-            t_inputs.resize(NumMinCPPNInputs());
-            for(int n=0; n<net.m_neurons[i].m_substrate_coords.size(); n++)
-                   t_inputs[n] = net.m_neurons[i].m_substrate_coords[n];
-
-            if (subst.m_with_distance)
-                t_inputs[CPPN_numinputs - 2] = 0.0;//sqrt(sqr(net.m_neurons[i].m_sx) + sqr(net.m_neurons[i].m_sy)); // distance from 0,0
-            t_inputs[CPPN_numinputs - 1] = 1.0; // the CPPN's bias
-
-            t_temp_phenotype.Input(t_inputs);
+    // The links to query and the coordinates of the neurons don't change between genomes,
+    // the substrate keeps them computed
+    const std::vector<Substrate::LinkRange>& t_ranges = subst.GetLinkRanges();
+    const double* t_coords = subst.GetPackedCoords().data();
 
-            // activate as many times as deep
-            for(uint d=0; d<dp; d++)
-                t_temp_phenotype.Activate();
-
-            double t_tc   = t_temp_phenotype.Output()[1];
-            double t_bias = t_temp_phenotype.Output()[2];
-
-            Clamp(t_tc, -1, 1);
-            Clamp(t_bias, -1, 1);
-
-            // rescale the values
-            Scale(t_tc,   -1, 1, subst.m_min_time_const, subst.m_max_time_const);
-            Scale(t_bias, -1, 1, -subst.m_max_weight_and_bias,   subst.m_max_weight_and_bias);
+    // The CPPN input for connection "j" to "i" (or for neuron "i" when j == -1, to get its
+    // time constant and bias in leaky mode - then only its position is given, as the source)
+    // the input is like
+    // x000|xx00|1 - 1D -> 2D connection
+    // xx00|xx00|1 - 2D -> 2D connection
+    // xx00|xxx0|1 - 2D -> 3D connection
+    // if max_dims is 4 and no distance input
+    auto t_fill_query = [&](double* a_row, int j, unsigned int i)
+    {
+        std::fill(a_row, a_row + CPPN_numinputs, 0.0);
 
-            net.m_neurons[i].m_timeconst = t_tc;
-            net.m_neurons[i].m_bias      = t_bias;
+        if (j < 0)
+        {
+            std::copy(t_coords + i * max_dims, t_coords + (i + 1) * max_dims, a_row);
         }
-
-        // loop all neurons
-        for(unsigned int j=0; j<net.m_neurons.size(); j++)
+        else
         {
-            // this is connection "j" to "i"
-
-            // conditions for canceling the CPPN query
-            if (
-               ( (!subst.m_allow_input_hidden_links) &&
-               ( (net.m_neurons[j].m_type == INPUT ) && (net.m_neurons[i].m_type == HIDDEN) ))
-
-            || ( (!subst.m_allow_input_output_links) &&
-               ( (net.m_neurons[j].m_type == INPUT ) && (net.m_neurons[i].m_type == OUTPUT) ))
+            // from
+            std::copy(t_coords + j * max_dims, t_coords + (j + 1) * max_dims, a_row);
+            // to
+            std::copy(t_coords + i * max_dims, t_coords + (i + 1) * max_dims, a_row + max_dims);
+        }
 
-            || ( (!subst.m_allow_hidden_hidden_links) &&
-               ( (net.m_neurons[j].m_type == HIDDEN ) && (net.m_neurons[i].m_type == HIDDEN) ))
+        if (subst.m_with_distance)
+            a_row[CPPN_numinputs - 2] = 0.0;//sqrt(sqr(net.m_neurons[i].m_sx) + sqr(net.m_neurons[i].m_sy)); // distance from 0,0
+        a_row[CPPN_numinputs - 1] = 1.0; // the CPPN's bias
+    };
 
-            || ( (!subst.m_allow_hidden_output_links) &&
-               ( (net.m_neurons[j].m_type == HIDDEN ) && (net.m_neurons[i].m_type == OUTPUT) ))
+    auto t_set_leaky = [&](unsigned int i, double t_tc, double t_bias)
+    {
+        Clamp(t_tc, -1, 1);
+        Clamp(t_bias, -1, 1);
 
-            || ( (!subst.m_allow_output_hidden_links) &&
-               ( (net.m_neurons[j].m_type == OUTPUT ) && (net.m_neurons[i].m_type == HIDDEN) ))
+        // rescale the values
+        Scale(t_tc,   -1, 1, subst.m_min_time_const, subst.m_max_time_const);
+        Scale(t_bias, -1, 1, -subst.m_max_weight_and_bias,   subst.m_max_weight_and_bias);
 
-            || ( (!subst.m_allow_output_output_links) &&
-               ( (net.m_neurons[j].m_type == INPUT ) && (net.m_neurons[i].m_type == OUTPUT) ))
+        net.m_neurons[i].m_timeconst = t_tc;
+        net.m_neurons[i].m_bias      = t_bias;
+    };
 
-            || ( (!subst.m_allow_looped_hidden_links) &&
-               ( (net.m_neurons[j].m_type == HIDDEN ) && (net.m_neurons[i].m_type == HIDDEN) && (i == j)))
+    auto t_add_link = [&](unsigned int j, unsigned int i, double t_weight)
+    {
+        Clamp(t_weight, -1, 1);
 
-            || ( (!subst.m_allow_looped_output_links) &&
-               ( (net.m_neurons[j].m_type == OUTPUT ) && (net.m_neurons[i].m_type == OUTPUT) && (i == j)))
+        double t_abs_weight = (t_weight < 0)? - t_weight : t_weight;
+        if (t_abs_weight > subst.m_link_threshold)
+        {
+            // now this weight will be scaled
+            if (t_weight < 0)
+                Scale(t_weight, -1, -subst.m_link_threshold, -subst.m_max_weight_and_bias, 0);
+            else
+                Scale(t_weight, subst.m_link_threshold, 1, 0, subst.m_max_weight_and_bias);
 
+            // build the connection
+            Connection t_c;
 
-            )
-                continue;
+            t_c.m_source_neuron_idx = j;
+            t_c.m_target_neuron_idx = i;
+            t_c.m_weight = t_weight;
+            t_c.m_recur_flag = false;
 
-            // Take the weight of this connection by querying the CPPN
-            // as many times as deep (recurrent or looped CPPNs may be very slow!!!*)
-            std::vector<double> t_inputs;
-            t_inputs.resize(NumMinCPPNInputs());
+            net.AddConnection(t_c);
+        }
+    };
 
-            uint from_dims = net.m_neurons[j].m_substrate_coords.size();
-            uint to_dims = net.m_neurons[i].m_substrate_coords.size();
+    if (t_feed_forward)
+    {
+        // The queries are independent of each other, so they go through the CPPN in batches.
+        // The batch is kept small enough for the CPPN activations to stay in the cache.
+        const unsigned int t_batch_size = 1024;
+        std::vector<double> t_inputs;
+        std::vector<double> t_outputs;
+        std::vector< std::pair<unsigned int, unsigned int> > t_links; // (j, i) of the queries in the batch
+        t_inputs.reserve(t_batch_size * CPPN_numinputs);
+        t_links.reserve(t_batch_size);
 
-            // input the node positions to the CPPN
-            // from
-            for(uint n=0; n<from_dims; n++)
-                t_inputs[n] = net.m_neurons[j].m_substrate_coords[n];
-            // to
-            for(uint n=0; n<to_dims; n++)
-                t_inputs[max_dims + n] = net.m_neurons[i].m_substrate_coords[n];
+        if (subst.m_leaky)
+        {
+            // neuron specific stuff
+            // Inputs for the generation of time consts and biases across
+            // the nodes in the substrate
+            for(unsigned int i=net.NumInputs(); i<net.m_neurons.size(); i+=t_batch_size)
+            {
+                unsigned int t_end = std::min<unsigned int>(i + t_batch_size, net.m_neurons.size());
+                t_inputs.resize((t_end - i) * CPPN_numinputs);
+                for(unsigned int k=i; k<t_end; k++)
+                    t_fill_query(&t_inputs[(k - i) * CPPN_numinputs], -1, k);
 
-            // the input is like
-            // x000|xx00|1 - 1D -> 2D connection
-            // xx00|xx00|1 - 2D -> 2D connection
-            // xx00|xxx0|1 - 2D -> 3D connection
-            // if max_dims is 4 and no distance input
+                t_temp_phenotype.ActivateBatch(t_inputs, t_outputs);
 
-            if (subst.m_with_distance)
-                t_inputs[CPPN_numinputs - 2] = 0.0;//sqrt(sqr(net.m_neurons[i].m_sx) + sqr(net.m_neurons[i].m_sy)); // distance from 0,0
+                for(unsigned int k=i; k<t_end; k++)
+                    t_set_leaky(k, t_outputs[(k - i) * t_cppn_outputs + 1], t_outputs[(k - i) * t_cppn_outputs + 2]);
+            }
+        }
 
-            t_inputs[CPPN_numinputs - 1] = 1.0;
+        // the connections are added in the same order as querying them one by one
+        auto t_flush = [&]()
+        {
+            if (t_links.empty())
+                return;
 
+            t_temp_phenotype.ActivateBatch(t_inputs, t_outputs);
 
-            // flush between each query
-            t_temp_phenotype.Flush();
-            t_temp_phenotype.Input(t_inputs);
+            for(unsigned int k=0; k<t_links.size(); k++)
+                t_add_link(t_links[k].first, t_links[k].second, t_outputs[k * t_cppn_outputs]);
 
-            // activate as many times as deep
-            for(uint d=0; d<dp; d++)
-                t_temp_phenotype.Activate();
+            t_inputs.clear();
+            t_links.clear();
+        };
 
-            // the output is a weight
-            double t_weight = t_temp_phenotype.Output()[0];
+        for(const Substrate::LinkRange& t_range : t_ranges)
+        {
+            const unsigned int i = t_range.m_target;
+            for(unsigned int j=t_range.m_source_begin; j<t_range.m_source_end; j++)
+            {
+                // this is connection "j" to "i"
+                t_inputs.resize(t_inputs.size() + CPPN_numinputs);
+                t_fill_query(&t_inputs[t_inputs.size() - CPPN_numinputs], j, i);
+                t_links.push_back(std::make_pair(j, i));
 
-            Clamp(t_weight, -1, 1);
+                if (t_links.size() == t_batch_size)
+                    t_flush();
+            }
+        }
+        t_flush();
+    }
+    else
+    {
+        std::vector<double> t_inputs(CPPN_numinputs);
 
-            double t_abs_weight = (t_weight < 0)? - t_weight : t_weight;
-            if (t_abs_weight > subst.m_link_threshold)
+        if (subst.m_leaky)
+        {
+            // only incoming connections, so loop only the hidden and output neurons
+            for(unsigned int i=net.NumInputs(); i<net.m_neurons.size(); i++)
             {
-                // now this weight will be scaled
-                if (t_weight < 0)
-                    Scale(t_weight, -1, -subst.m_link_threshold, -subst.m_max_weight_and_bias, 0);
-                else
-                    Scale(t_weight, subst.m_link_threshold, 1, 0, subst.m_max_weight_and_bias);
+                t_temp_phenotype.Flush();
+                t_fill_query(t_inputs.data(), -1, i);
+                t_temp_phenotype.Input(t_inputs);
 
-                // build the connection
-                Connection t_c;
+                // activate as many times as deep
+                for(uint d=0; d<dp; d++)
+                    t_temp_phenotype.Activate();
 
-                t_c.m_source_neuron_idx = j;
-                t_c.m_target_neuron_idx = i;
-                t_c.m_weight = t_weight;
-                t_c.m_recur_flag = false;
+                std::vector<double> t_out = t_temp_phenotype.Output();
+                t_set_leaky(i, t_out[1], t_out[2]);
+            }
+        }
 
-                net.AddConnection(t_c);
+        for(const Substrate::LinkRange& t_range : t_ranges)
+        {
+            const unsigned int i = t_range.m_target;
+            for(unsigned int j=t_range.m_source_begin; j<t_range.m_source_end; j++)
+            {
+                // this is connection "j" to "i"
+                // Take the weight of this connection by querying the CPPN
+                // as many times as deep (recurrent or looped CPPNs may be very slow!!!*)
+                // flush between each query
+                t_temp_phenotype.Flush();
+                t_fill_query(t_inputs.data(), j, i);
+                t_temp_phenotype.Input(t_inputs);
+
+                // activate as many times as deep
+                for(uint d=0; d<dp; d++)
+                    t_temp_phenotype.Activate();
+
+                // the output is a weight
+                t_add_link(j, i, t_temp_phenotype.Output()[0]);
             }
         }
     }
@@ -757,10 +868,16 @@ void Genome::BuildHyperNEATESPhenotype(NeuralNetwork& net, EvolvableSubstrate &s
         net.AddNeuron(it->second);
     }
 
+    // neuron id -> index in the network, instead of searching it per connection
+    std::map<unsigned int, int> t_neuron_idx;
+    for(size_t i=0; i<net.m_neurons.size(); i++){
+        t_neuron_idx.insert(std::make_pair(net.m_neurons[i].id, static_cast<int>(i)));
+    }
+
     for(size_t i=0; i<t_connections.size(); i++){
         Connection conn(t_connections[i]);
-        conn.m_source_neuron_idx = GetNeuronIndex(t_connections[i].m_source_neuron_idx, net.m_neurons);
-        conn.m_target_neuron_idx = GetNeuronIndex(t_connections[i].m_target_neuron_idx, net.m_neurons);
+        conn.m_source_neuron_idx = t_neuron_idx.at(t_connections[i].m_source_neuron_idx);
+        conn.m_target_neuron_idx = t_neuron_idx.at(t_connections[i].m_target_neuron_idx);
         net.GetNeuronByIndex(conn.m_source_neuron_idx);
         net.GetNeuronByIndex(conn.m_target_neuron_idx);
         net.AddConnection(conn);
@@ -792,11 +909,27 @@ void Genome::DerivePhenotypicChanges(NeuralNetwork& a_Net)
 
 
 // Returns the absolute distance between this genome and a_G
-double Genome::CompatibilityDistance(Genome &a_G, Parameters& a_Parameters)
+double Genome::CompatibilityDistance(const Genome &a_G, const Parameters& a_Parameters) const
+{
+    return CompatibilityDistance(a_G, a_Parameters, std::numeric_limits<double>::infinity());
+}
+
+// Stops as soon as the distance is known to be above a_Limit
+// The excess and disjoint terms only grow during the walk, so when they alone
+// pass the limit the rest doesn't matter. This holds only if no coefficient is negative.
+double Genome::CompatibilityDistance(const Genome &a_G, const Parameters& a_Parameters, double a_Limit) const
 {
+    if ((a_Parameters.ExcessCoeff < 0) || (a_Parameters.DisjointCoeff < 0) || (a_Parameters.WeightDiffCoeff < 0) ||
+        (a_Parameters.ActivationADiffCoeff < 0) || (a_Parameters.ActivationBDiffCoeff < 0) ||
+        (a_Parameters.TimeConstantDiffCoeff < 0) || (a_Parameters.BiasDiffCoeff < 0) ||
+        (a_Parameters.ActivationFunctionDiffCoeff < 0))
+    {
+        a_Limit = std::numeric_limits<double>::infinity();
+    }
+
     // iterators for moving through the genomes' genes
-    std::vector<LinkGene>::iterator t_g1;
-    std::vector<LinkGene>::iterator t_g2;
+    std::vector<LinkGene>::const_iterator t_g1;
+    std::vector<LinkGene>::const_iterator t_g2;
 
     // this variable is the total distance between the genomes
     // if it passes beyond the compatibility treshold, the function returns false
@@ -815,6 +948,12 @@ double Genome::CompatibilityDistance(Genome &a_G, Parameters& a_Parameters)
     double t_num_matching_links = 0;
     double t_num_matching_neurons = 0;
 
+    // choose between normalizing for genome size or not
+    double t_normalizer = 1.0;//static_cast<double>(t_max_genome_size);
+
+    if (t_normalizer == 0)
+        t_normalizer = 1;
+
     // used for percentage of excess/disjoint genes calculation
     // int t_max_genome_size = static_cast<int> (NumLinks()   < a_G.NumLinks())   ? (a_G.NumLinks())   : (NumLinks());
     // int t_max_neurons     = static_cast<int> (NumNeurons() < a_G.NumNeurons()) ? (a_G.NumNeurons()) : (NumNeurons());
@@ -822,114 +961,108 @@ double Genome::CompatibilityDistance(Genome &a_G, Parameters& a_Parameters)
     t_g1 = m_LinkGenes.begin();
     t_g2 = a_G.m_LinkGenes.begin();
 
-    // Step through the genes until both genomes end
-    while( ! ((t_g1 == m_LinkGenes.end()) && ((t_g2 == a_G.m_LinkGenes.end()))) )
+    // Step through the genes until one of the genomes ends
+    while((t_g1 != m_LinkGenes.end()) && (t_g2 != a_G.m_LinkGenes.end()))
     {
-        // end of first genome?
-        if (t_g1 == m_LinkGenes.end())
-        {
-            // add to the total distance
-            t_num_excess++;
-            t_g2++;
-        }
-        else if
-        // end of second genome?
-        (t_g2 == a_G.m_LinkGenes.end())
+        // extract the innovation numbers
+        int t_g1innov = t_g1->InnovationID();
+        int t_g2innov = t_g2->InnovationID();
+
+        // matching genes?
+        if (t_g1innov == t_g2innov)
         {
-            // add to the total distance
-            t_num_excess++;
+            t_num_matching_links++;
+
+            double t_wdiff = (t_g1->GetWeight() - t_g2->GetWeight());
+            if (t_wdiff < 0) t_wdiff = -t_wdiff; // make sure it is positive
+
+            t_total_weight_difference += t_wdiff;
             t_g1++;
+            t_g2++;
         }
         else
         {
-            // extract the innovation numbers
-            int t_g1innov = t_g1->InnovationID();
-            int t_g2innov = t_g2->InnovationID();
-
-            // matching genes?
-            if (t_g1innov == t_g2innov)
-            {
-                t_num_matching_links++;
-
-                double t_wdiff = (t_g1->GetWeight() - t_g2->GetWeight());
-                if (t_wdiff < 0) t_wdiff = -t_wdiff; // make sure it is positive
-
-                t_total_weight_difference += t_wdiff;
-                t_g1++;
-                t_g2++;
-            }
-            else if
             // disjoint
-            (t_g1innov < t_g2innov)
-            {
-                t_num_disjoint++;
+            t_num_disjoint++;
+
+            if (t_g1innov < t_g2innov)
                 t_g1++;
-            }
-            else if
-            // disjoint
-            (t_g1innov > t_g2innov)
-            {
-                t_num_disjoint++;
+            else
                 t_g2++;
-            }
+
+            if ((a_Parameters.DisjointCoeff * (t_num_disjoint / t_normalizer)) > a_Limit)
+                return a_Parameters.DisjointCoeff * (t_num_disjoint / t_normalizer);
         }
     }
 
+    // whatever is left in the other genome is excess
+    t_num_excess += static_cast<double>(m_LinkGenes.end() - t_g1);
+    t_num_excess += static_cast<double>(a_G.m_LinkGenes.end() - t_g2);
+
+    // if there are no matching links, make it 1.0 to avoid divide error
+    if (t_num_matching_links == 0)
+        t_num_matching_links = 1;
+
+    t_total_distance =
+        (a_Parameters.ExcessCoeff                 * (t_num_excess   / t_normalizer)) +
+        (a_Parameters.DisjointCoeff               * (t_num_disjoint / t_normalizer)) +
+        (a_Parameters.WeightDiffCoeff             * (t_total_weight_difference / t_num_matching_links));
+
+    // the neuron terms can't make it smaller
+    if (t_total_distance > a_Limit)
+        return t_total_distance;
+
     // find matching neuron IDs
-    for(unsigned int i=0; i < NumNeurons(); i++)
+    // Walk both genomes' neurons in ID order, using the sorted neuron indices.
+    // For every neuron of this genome, the first neuron of a_G with the same ID is its match.
+    unsigned int t_other = 0;
+    for(unsigned int i=0; i < m_NeuronIndex.Size(); i++)
     {
+        const NeuronGene& t_neuron = m_NeuronGenes[m_NeuronIndex.PositionAt(i)];
+
         // no inputs considered for comparison
-        if ((m_NeuronGenes[i].Type() != INPUT) && (m_NeuronGenes[i].Type() != BIAS))
+        if ((t_neuron.Type() == INPUT) || (t_neuron.Type() == BIAS))
+            continue;
+
+        while((t_other < a_G.m_NeuronIndex.Size()) && (a_G.m_NeuronIndex.KeyAt(t_other) < m_NeuronIndex.KeyAt(i)))
+            t_other++;
+
+        // a match
+        if ((t_other < a_G.m_NeuronIndex.Size()) && (a_G.m_NeuronIndex.KeyAt(t_other) == m_NeuronIndex.KeyAt(i)))
         {
-            // a match
-            if (a_G.HasNeuronID( m_NeuronGenes[i].ID() ))
-            {
-                t_num_matching_neurons++;
+            const NeuronGene& t_other_neuron = a_G.m_NeuronGenes[a_G.m_NeuronIndex.PositionAt(t_other)];
 
-                double t_A_difference = m_NeuronGenes[i].m_A  - a_G.GetNeuronByID( m_NeuronGenes[i].ID()).m_A;
-                if (t_A_difference < 0.0f) t_A_difference = -t_A_difference;
-                t_total_A_difference += t_A_difference;
+            t_num_matching_neurons++;
 
-                double t_B_difference = m_NeuronGenes[i].m_B  - a_G.GetNeuronByID( m_NeuronGenes[i].ID()).m_B;
-                if (t_B_difference < 0.0f) t_B_difference = -t_B_difference;
-                t_total_B_difference += t_B_difference;
+            double t_A_difference = t_neuron.m_A  - t_other_neuron.m_A;
+            if (t_A_difference < 0.0f) t_A_difference = -t_A_difference;
+            t_total_A_difference += t_A_difference;
 
-                double t_time_constant_difference = m_NeuronGenes[i].m_TimeConstant - a_G.GetNeuronByID( m_NeuronGenes[i].ID()).m_TimeConstant;
-                if (t_time_constant_difference < 0.0f) t_time_constant_difference = -t_time_constant_difference;
-                t_total_timeconstant_difference += t_time_constant_difference;
+            double t_B_difference = t_neuron.m_B  - t_other_neuron.m_B;
+            if (t_B_difference < 0.0f) t_B_difference = -t_B_difference;
+            t_total_B_difference += t_B_difference;
 
-                double t_bias_difference = m_NeuronGenes[i].m_Bias - a_G.GetNeuronByID( m_NeuronGenes[i].ID()).m_Bias;
-                if (t_bias_difference < 0.0f) t_bias_difference = -t_bias_difference;
-                t_total_bias_difference += t_bias_difference;
+            double t_time_constant_difference = t_neuron.m_TimeConstant - t_other_neuron.m_TimeConstant;
+            if (t_time_constant_difference < 0.0f) t_time_constant_difference = -t_time_constant_difference;
+            t_total_timeconstant_difference += t_time_constant_difference;
 
-                // Activation function type difference is found
-                if (m_NeuronGenes[i].m_ActFunction != a_G.GetNeuronByID( m_NeuronGenes[i].ID()).m_ActFunction)
-                {
-                    t_total_num_activation_difference++;
-                }
+            double t_bias_difference = t_neuron.m_Bias - t_other_neuron.m_Bias;
+            if (t_bias_difference < 0.0f) t_bias_difference = -t_bias_difference;
+            t_total_bias_difference += t_bias_difference;
+
+            // Activation function type difference is found
+            if (t_neuron.m_ActFunction != t_other_neuron.m_ActFunction)
+            {
+                t_total_num_activation_difference++;
             }
         }
     }
 
-
-    // choose between normalizing for genome size or not
-    double t_normalizer = 1.0;//static_cast<double>(t_max_genome_size);
-
-    // if there are no matching links, make it 1.0 to avoid divide error
-    if (t_num_matching_links == 0)
-        t_num_matching_links = 1;
-
     // if there are no matching neurons, make it 1.0 to avoid divide error
     if (t_num_matching_neurons == 0)
         t_num_matching_neurons = 1;
 
-    if (t_normalizer == 0)
-        t_normalizer = 1;
-
-    t_total_distance =
-        (a_Parameters.ExcessCoeff                 * (t_num_excess   / t_normalizer)) +
-        (a_Parameters.DisjointCoeff               * (t_num_disjoint / t_normalizer)) +
-        (a_Parameters.WeightDiffCoeff             * (t_total_weight_difference / t_num_matching_links)) +
+    t_total_distance +=
         (a_Parameters.ActivationADiffCoeff        * (t_total_A_difference / t_num_matching_neurons)) +
         (a_Parameters.ActivationBDiffCoeff        * (t_total_B_difference / t_num_matching_neurons)) +
         (a_Parameters.TimeConstantDiffCoeff       * (t_total_timeconstant_difference / t_num_matching_neurons)) +
@@ -940,7 +1073,7 @@ double Genome::CompatibilityDistance(Genome &a_G, Parameters& a_Parameters)
 }
 
 // Returns true if this genome and a_G are compatible (belong in the same species)
-bool Genome::IsCompatibleWith(Genome& a_G, Parameters& a_Parameters)
+bool Genome::IsCompatibleWith(const Genome& a_G, const Parameters& a_Parameters) const
 {
     // full compatibility cases
     if (this == &a_G)
@@ -952,7 +1085,7 @@ bool Genome::IsCompatibleWith(Genome& a_G, Parameters& a_Parameters)
     if ((NumLinks() == 0) && (a_G.NumLinks() == 0))
         return true;
 
-    double t_total_distance = CompatibilityDistance(a_G, a_Parameters);
+    double t_total_distance = CompatibilityDistance(a_G, a_Parameters, a_Parameters.CompatTreshold);
 
     if (t_total_distance <= a_Parameters.CompatTreshold)
         return true;  // compatible
@@ -1079,7 +1212,7 @@ bool Genome::Mutate_AddNeuron(InnovationDatabase &a_Innovs, Parameters& a_Parame
         if (t_iter->InnovationID() == m_LinkGenes[t_link_num].InnovationID())
         {
             // found it! now erase..
-            m_LinkGenes.erase(t_iter);
+            EraseLinkGene(static_cast<unsigned int>(t_iter - m_LinkGenes.begin()));
             break;
         }
     }
@@ -1128,7 +1261,7 @@ bool Genome::Mutate_AddNeuron(InnovationDatabase &a_Innovs, Parameters& a_Parame
                       GetRandomActivation(a_Parameters, a_RNG) );
 
         // Add the NeuronGene
-        m_NeuronGenes.push_back( t_ngene );
+        AddNeuronGene( t_ngene );
 
         // Now the links
 
@@ -1136,10 +1269,10 @@ bool Genome::Mutate_AddNeuron(InnovationDatabase &a_Innovs, Parameters& a_Parame
         bool t_recurrentflag = t_chosenlink.IsRecurrent();
 
         // First link
-        m_LinkGenes.push_back( LinkGene(t_in, t_nid, t_l1id, 1.0, t_recurrentflag) );
+        AddLinkGene( LinkGene(t_in, t_nid, t_l1id, 1.0, t_recurrentflag) );
 
         // Second link
-        m_LinkGenes.push_back( LinkGene(t_nid, t_out, t_l2id, t_orig_weight, t_recurrentflag) );
+        AddLinkGene( LinkGene(t_nid, t_out, t_l2id, t_orig_weight, t_recurrentflag) );
     }
     else
     {
@@ -1223,11 +1356,11 @@ bool Genome::Mutate_AddNeuron(InnovationDatabase &a_Innovs, Parameters& a_Parame
         bool t_recurrentflag = t_chosenlink.IsRecurrent();
 
         // Add the NeuronGene
-        m_NeuronGenes.push_back( t_ngene );
+        AddNeuronGene( t_ngene );
         // First link
-        m_LinkGenes.push_back( LinkGene(t_in, t_nid, t_l1id, 1.0, t_recurrentflag) );
+        AddLinkGene( LinkGene(t_in, t_nid, t_l1id, 1.0, t_recurrentflag) );
         // Second link
-        m_LinkGenes.push_back( LinkGene(t_nid, t_out, t_l2id, t_orig_weight, t_recurrentflag) );
+        AddLinkGene( LinkGene(t_nid, t_out, t_l2id, t_orig_weight, t_recurrentflag) );
     }
 
     return true;
@@ -1438,12 +1571,12 @@ bool Genome::Mutate_AddLink(InnovationDatabase &a_Innovs, Parameters& a_Paramete
     {
         // Make new innovation and add the connection gene
         t_innovid = a_Innovs.AddLinkInnovation(t_n1id, t_n2id);
-        m_LinkGenes.push_back( LinkGene(t_n1id, t_n2id, t_innovid, t_weight, t_MakeRecurrent) );
+        AddLinkGene( LinkGene(t_n1id, t_n2id, t_innovid, t_weight, t_MakeRecurrent) );
     }
     else
     {
         // This innovation is already present, so just use it
-        m_LinkGenes.push_back( LinkGene(t_n1id, t_n2id, t_innovid, t_weight, t_MakeRecurrent) );
+        AddLinkGene( LinkGene(t_n1id, t_n2id, t_innovid, t_weight, t_MakeRecurrent) );
     }
 
     // All done.
@@ -1457,19 +1590,10 @@ bool Genome::Mutate_AddLink(InnovationDatabase &a_Innovs, Parameters& a_Paramete
 // Removes the link with the specified innovation ID
 void Genome::RemoveLinkGene(unsigned int a_InnovID)
 {
-    // for iterating through the genes
-    std::vector<LinkGene>::iterator t_curlink = m_LinkGenes.begin();
-
-    while(t_curlink != m_LinkGenes.end())
+    int t_idx = m_LinkIndex.Find(a_InnovID);
+    if (t_idx != -1)
     {
-        if (t_curlink->InnovationID() == a_InnovID)
-        {
-            // found it - erase & quit
-            t_curlink = m_LinkGenes.erase(t_curlink);
-            break;
-        }
-
-        t_curlink++;
+        EraseLinkGene(static_cast<unsigned int>(t_idx));
     }
 }
 
@@ -1498,19 +1622,10 @@ void Genome::RemoveNeuronGene(unsigned int a_ID)
     }
 
     // Now is safe to remove the neuron
-    // find it first
-    std::vector<NeuronGene>::iterator t_curneuron = m_NeuronGenes.begin();
-
-    while(t_curneuron != m_NeuronGenes.end())
+    int t_idx = m_NeuronIndex.Find(a_ID);
+    if (t_idx != -1)
     {
-        if (t_curneuron->ID() == a_ID)
-        {
-            // found it, erase and quit
-            m_NeuronGenes.erase(t_curneuron);
-            break;
-        }
-
-        t_curneuron++;
+        EraseNeuronGene(static_cast<unsigned int>(t_idx));
     }
 }
 
@@ -1778,7 +1893,7 @@ bool Genome::Mutate_RemoveSimpleNeuron(InnovationDatabase& a_Innovs, RNG& a_RNG)
         {
             // Add the innovation and the link gene
             int t_newinnov = a_Innovs.AddLinkInnovation(m_LinkGenes[t_l1idx].FromNeuronID(), m_LinkGenes[t_l2idx].ToNeuronID());
-            m_LinkGenes.push_back( LinkGene(m_LinkGenes[t_l1idx].FromNeuronID(), m_LinkGenes[t_l2idx].ToNeuronID(), t_newinnov, t_weight, false) );
+            AddLinkGene( LinkGene(m_LinkGenes[t_l1idx].FromNeuronID(), m_LinkGenes[t_l2idx].ToNeuronID(), t_newinnov, t_weight, false) );
 
             // Remove the neuron now
             RemoveNeuronGene( m_NeuronGenes[t_neurons_to_delete[t_choice]].ID() );
@@ -1790,7 +1905,7 @@ bool Genome::Mutate_RemoveSimpleNeuron(InnovationDatabase& a_Innovs, RNG& a_RNG)
         else
         {
             // Add the link and remove the neuron
-            m_LinkGenes.push_back( LinkGene(m_LinkGenes[t_l1idx].FromNeuronID(), m_LinkGenes[t_l2idx].ToNeuronID(), t_innovid, t_weight, false) );
+            AddLinkGene( LinkGene(m_LinkGenes[t_l1idx].FromNeuronID(), m_LinkGenes[t_l2idx].ToNeuronID(), t_innovid, t_weight, false) );
 
             // Remove the neuron now
             RemoveNeuronGene( m_NeuronGenes[t_neurons_to_delete[t_choice]].ID() );
@@ -2026,7 +2141,7 @@ void Genome::Mutate_NeuronBiases(Parameters& a_Parameters, RNG& a_RNG)
 // This is multipoint mating - genes inherited randomly
 // Disjoint and excess genes are inherited from the fittest parent
 // If fitness is equal, the smaller genome is assumed to be the better one
-Genome Genome::Mate(Genome& a_Dad, bool a_MateAverage, bool a_InterSpecies, RNG& a_RNG)
+Genome Genome::Mate(const Genome& a_Dad, bool a_MateAverage, bool a_InterSpecies, RNG& a_RNG) const
 {
     // Cannot mate with itself
     if (GetID() == a_Dad.GetID())
@@ -2043,8 +2158,8 @@ Genome Genome::Mate(Genome& a_Dad, bool a_MateAverage, bool a_InterSpecies, RNG&
 
     // create iterators so we can step through each parents genes and set
     // them to the first gene of each parent
-    std::vector<LinkGene>::iterator t_curMum = m_LinkGenes.begin();
-    std::vector<LinkGene>::iterator t_curDad = a_Dad.m_LinkGenes.begin();
+    std::vector<LinkGene>::const_iterator t_curMum = m_LinkGenes.begin();
+    std::vector<LinkGene>::const_iterator t_curDad = a_Dad.m_LinkGenes.begin();
 
     // this will hold a copy of the gene we wish to add at each step
     LinkGene t_selectedgene(0,0,-1,0,false);
@@ -2055,10 +2170,10 @@ Genome Genome::Mate(Genome& a_Dad, bool a_MateAverage, bool a_InterSpecies, RNG&
     // the inputs
     for(unsigned int i=0; i<m_NumInputs-1; i++)
     {
-        t_baby.m_NeuronGenes.push_back( NeuronGene(INPUT, i+1, 0) );
+        t_baby.AddNeuronGene( NeuronGene(INPUT, i+1, 0) );
     }
     // the bias
-    t_baby.m_NeuronGenes.push_back( NeuronGene(BIAS, m_NumInputs, 0) );
+    t_baby.AddNeuronGene( NeuronGene(BIAS, m_NumInputs, 0) );
 
     // the outputs will be inherited randomly from either parent
     // because otherwise the neuron-specific parameters would be wiped away
@@ -2077,7 +2192,7 @@ Genome Genome::Mate(Genome& a_Dad, bool a_MateAverage, bool a_InterSpecies, RNG&
             t_tempneuron = a_Dad.GetNeuronByIndex(i+m_NumInputs);
         }
 
-        t_baby.m_NeuronGenes.push_back( t_tempneuron );
+        t_baby.AddNeuronGene( t_tempneuron );
     }
 
     // if they are of equal fitness use the shorter (because we want to keep
@@ -2236,7 +2351,7 @@ Genome Genome::Mate(Genome& a_Dad, bool a_MateAverage, bool a_InterSpecies, RNG&
         {
             if (!t_skip)
             {
-                t_baby.m_LinkGenes.push_back(t_selectedgene);
+                t_baby.AddLinkGene(t_selectedgene);
 
                 // Check if we already have the nodes referred to in t_selectedgene.
                 // If not, they need to be added.
@@ -2255,18 +2370,18 @@ Genome Genome::Mate(Genome& a_Dad, bool a_MateAverage, bool a_InterSpecies, RNG&
                         if (a_RNG.RandFloat() < 0.5f)
                         {
                             // add mom's neuron to the baby
-                            t_baby.m_NeuronGenes.push_back( m_NeuronGenes[GetNeuronIndex(t_selectedgene.FromNeuronID())] );
+                            t_baby.AddNeuronGene( m_NeuronGenes[GetNeuronIndex(t_selectedgene.FromNeuronID())] );
                         }
                         else
                         {
                             // add dad's neuron to the baby
-                            t_baby.m_NeuronGenes.push_back( a_Dad.m_NeuronGenes[a_Dad.GetNeuronIndex(t_selectedgene.FromNeuronID())] );
+                            t_baby.AddNeuronGene( a_Dad.m_NeuronGenes[a_Dad.GetNeuronIndex(t_selectedgene.FromNeuronID())] );
                         }
                     }
                     else
                     {
                         // add mom's neuron to the baby
-                        t_baby.m_NeuronGenes.push_back( m_NeuronGenes[GetNeuronIndex(t_selectedgene.FromNeuronID())] );
+                        t_baby.AddNeuronGene( m_NeuronGenes[GetNeuronIndex(t_selectedgene.FromNeuronID())] );
                     }
                 }
 
@@ -2280,18 +2395,18 @@ Genome Genome::Mate(Genome& a_Dad, bool a_MateAverage, bool a_InterSpecies, RNG&
                         if (a_RNG.RandFloat() < 0.5f)
                         {
                             // add mom's neuron to the baby
-                            t_baby.m_NeuronGenes.push_back( m_NeuronGenes[GetNeuronIndex(t_selectedgene.ToNeuronID())] );
+                            t_baby.AddNeuronGene( m_NeuronGenes[GetNeuronIndex(t_selectedgene.ToNeuronID())] );
                         }
                         else
                         {
                             // add dad's neuron to the baby
-                            t_baby.m_NeuronGenes.push_back( a_Dad.m_NeuronGenes[a_Dad.GetNeuronIndex(t_selectedgene.ToNeuronID())] );
+                            t_baby.AddNeuronGene( a_Dad.m_NeuronGenes[a_Dad.GetNeuronIndex(t_selectedgene.ToNeuronID())] );
                         }
                     }
                     else
                     {
                         // add mom's neuron to the baby
-                        t_baby.m_NeuronGenes.push_back( m_NeuronGenes[GetNeuronIndex(t_selectedgene.ToNeuronID())] );
+                        t_baby.AddNeuronGene( m_NeuronGenes[GetNeuronIndex(t_selectedgene.ToNeuronID())] );
                     }
 
                 }
@@ -2307,18 +2422,18 @@ Genome Genome::Mate(Genome& a_Dad, bool a_MateAverage, bool a_InterSpecies, RNG&
                         if (a_RNG.RandFloat() < 0.5f)
                         {
                             // add dad's neuron to the baby
-                            t_baby.m_NeuronGenes.push_back( a_Dad.m_NeuronGenes[a_Dad.GetNeuronIndex(t_selectedgene.FromNeuronID())] );
+                            t_baby.AddNeuronGene( a_Dad.m_NeuronGenes[a_Dad.GetNeuronIndex(t_selectedgene.FromNeuronID())] );
                         }
                         else
                         {
                             // add mom's neuron to the baby
-                            t_baby.m_NeuronGenes.push_back( m_NeuronGenes[GetNeuronIndex(t_selectedgene.FromNeuronID())] );
+                            t_baby.AddNeuronGene( m_NeuronGenes[GetNeuronIndex(t_selectedgene.FromNeuronID())] );
                         }
                     }
                     else
                     {
                         // add dad's neuron to the baby
-                        t_baby.m_NeuronGenes.push_back( a_Dad.m_NeuronGenes[a_Dad.GetNeuronIndex(t_selectedgene.FromNeuronID())] );
+                        t_baby.AddNeuronGene( a_Dad.m_NeuronGenes[a_Dad.GetNeuronIndex(t_selectedgene.FromNeuronID())] );
                     }
                 }
 
@@ -2332,18 +2447,18 @@ Genome Genome::Mate(Genome& a_Dad, bool a_MateAverage, bool a_InterSpecies, RNG&
                         if (a_RNG.RandFloat() < 0.5f)
                         {
                             // add dad's neuron to the baby
-                            t_baby.m_NeuronGenes.push_back( a_Dad.m_NeuronGenes[a_Dad.GetNeuronIndex(t_selectedgene.ToNeuronID())] );
+                            t_baby.AddNeuronGene( a_Dad.m_NeuronGenes[a_Dad.GetNeuronIndex(t_selectedgene.ToNeuronID())] );
                         }
                         else
                         {
                             // add mom's neuron to the baby
-                            t_baby.m_NeuronGenes.push_back( m_NeuronGenes[GetNeuronIndex(t_selectedgene.ToNeuronID())] );
+                            t_baby.AddNeuronGene( m_NeuronGenes[GetNeuronIndex(t_selectedgene.ToNeuronID())] );
                         }
                     }
                     else
                     {
                         // add dad's neuron to the baby
-                        t_baby.m_NeuronGenes.push_back( a_Dad.m_NeuronGenes[a_Dad.GetNeuronIndex(t_selectedgene.ToNeuronID())] );
+                        t_baby.AddNeuronGene( a_Dad.m_NeuronGenes[a_Dad.GetNeuronIndex(t_selectedgene.ToNeuronID())] );
                     }
                 }
             }
@@ -2389,6 +2504,7 @@ void Genome::SortGenes()
 {
     std::sort(m_NeuronGenes.begin(), m_NeuronGenes.end(), neuron_compare);
     std::sort(m_LinkGenes.begin(), m_LinkGenes.end(), link_compare);
+    RebuildIndex();
 }
 
 
@@ -2532,7 +2648,7 @@ Genome::Genome(std::ifstream& a_DataFile)
             NeuronGene t_neuron(static_cast<NeuronType>(t_type), t_id, t_splity);
             t_neuron.Init(t_a, t_b, t_timeconst, t_bias, static_cast<ActivationFunction>(t_activationfunc));
 
-            m_NeuronGenes.push_back( t_neuron );
+            AddNeuronGene( t_neuron );
         }
 
         if (t_Str == "Link")
@@ -2546,7 +2662,7 @@ Genome::Genome(std::ifstream& a_DataFile)
             a_DataFile >> t_isrecur;
             a_DataFile >> t_weight;
 
-            m_LinkGenes.push_back( LinkGene(t_from, t_to, t_innov, t_weight, static_cast<bool>(t_isrecur)) );
+            AddLinkGene( LinkGene(t_from, t_to, t_innov, t_weight, static_cast<bool>(t_isrecur)) );
         }
     }
     while( t_Str != "GenomeEnd");
@@ -36,6 +36,7 @@
 #include <boost/serialization/vector.hpp>
 
 #include <vector>
+#include <algorithm>
 #include "Random.h"
 #include "NeuralNetwork.h"
 #include "Substrate.h"
@@ -62,6 +63,73 @@ class EvolvableSubstrate;
 
 extern ActivationFunction GetRandomActivation(Parameters& a_Parameters, RNG & a_RNG);
 
+// A list of (key, position) pairs kept sorted, used to find genes by ID
+// with a binary search instead of scanning the gene lists.
+class GeneIndex
+{
+    std::vector< std::pair<unsigned long long, unsigned int> > m_Entries;
+
+public:
+
+    void Clear() { m_Entries.clear(); }
+
+    void Insert(unsigned long long a_Key, unsigned int a_Position)
+    {
+        std::pair<unsigned long long, unsigned int> t_entry(a_Key, a_Position);
+        m_Entries.insert(std::lower_bound(m_Entries.begin(), m_Entries.end(), t_entry), t_entry);
+    }
+
+    // Adds an entry without keeping the order, call Sort() after the last one
+    void Append(unsigned long long a_Key, unsigned int a_Position)
+    {
+        m_Entries.push_back(std::make_pair(a_Key, a_Position));
+    }
+
+    void Sort() { std::sort(m_Entries.begin(), m_Entries.end()); }
+
+    void Reserve(unsigned int a_Size) { m_Entries.reserve(a_Size); }
+
+    // Removes the entry of the gene at a_Position and moves the positions after it
+    // down by one, as the gene list does when the gene is erased
+    void Erase(unsigned int a_Position)
+    {
+        std::vector< std::pair<unsigned long long, unsigned int> >::iterator t_out = m_Entries.begin();
+        for(std::vector< std::pair<unsigned long long, unsigned int> >::iterator t_it = m_Entries.begin(); t_it != m_Entries.end(); t_it++)
+        {
+            if (t_it->second == a_Position)
+                continue;
+
+            *t_out = *t_it;
+            if (t_out->second > a_Position)
+                t_out->second--;
+            t_out++;
+        }
+        m_Entries.erase(t_out, m_Entries.end());
+    }
+
+    // Returns the lowest position stored for the key or -1 if it's not there
+    int Find(unsigned long long a_Key) const
+    {
+        std::vector< std::pair<unsigned long long, unsigned int> >::const_iterator t_it =
+            std::lower_bound(m_Entries.begin(), m_Entries.end(), std::make_pair(a_Key, 0u));
+
+        if ((t_it == m_Entries.end()) || (t_it->first != a_Key))
+            return -1;
+
+        return static_cast<int>(t_it->second);
+    }
+
+    // The entries in key order
+    unsigned int Size() const { return static_cast<unsigned int>(m_Entries.size()); }
+    unsigned long long KeyAt(unsigned int a_Idx) const { return m_Entries[a_Idx].first; }
+    unsigned int PositionAt(unsigned int a_Idx) const { return m_Entries[a_Idx].second; }
+
+    static unsigned long long LinkKey(unsigned int a_From, unsigned int a_To)
+    {
+        return (static_cast<unsigned long long>(a_From) << 32) | a_To;
+    }
+};
+
 class Genome
 {
     /////////////////////
@@ -75,6 +143,12 @@ private:
     std::vector<NeuronGene> m_NeuronGenes;
     std::vector<LinkGene>   m_LinkGenes;
 
+    // Lookup indices over the gene lists, kept in sync by every method that
+    // changes the genes (neuron ID, link innovation ID and link (from, to) pair)
+    GeneIndex m_NeuronIndex;
+    GeneIndex m_LinkIndex;
+    GeneIndex m_LinkPairIndex;
+
     // How many inputs/outputs
     unsigned int m_NumInputs;
     unsigned int m_NumOutputs;
@@ -94,6 +168,18 @@ private:
     ////////////////////
     // Private methods
 
+    // Append a gene and update the lookup indices
+    void AddNeuronGene(const NeuronGene& a_Neuron);
+    void AddLinkGene(const LinkGene& a_Link);
+
+    // Erase a gene and update the lookup indices
+    void EraseNeuronGene(unsigned int a_Position);
+    void EraseLinkGene(unsigned int a_Position);
+
+    // Rebuilds the lookup indices from the gene lists
+    // Call after the genes were reordered
+    void RebuildIndex();
+
     // Returns true if the specified neuron ID is present in the genome
     bool HasNeuronID(unsigned int a_id) const;
 
@@ -147,9 +233,15 @@ public:
     // copy constructor
     Genome(Genome& a_g);
 
+    // move constructor, takes over the genes without copying them
+    Genome(Genome&& a_g);
+
     // assignment operator
     Genome& operator=(const Genome& a_g);
 
+    // move assignment operator
+    Genome& operator=(Genome&& a_g);
+
     // comparison operator (nessesary for boost::python)
     // todo: implement a better comparison technique
     bool operator==(Genome const& other) const { return m_ID == other.m_ID; }
@@ -203,9 +295,9 @@ public:
     LinkGene GetLinkByInnovID(unsigned int a_ID) const
     {
         ASSERT(HasLinkByInnovID(a_ID));
-        for(unsigned int i=0; i<m_LinkGenes.size(); i++)
-            if (m_LinkGenes[i].InnovationID() == a_ID)
-                return m_LinkGenes[i];
+        int t_idx = m_LinkIndex.Find(a_ID);
+        if (t_idx != -1)
+            return m_LinkGenes[t_idx];
 
         // should never reach this code
         throw std::exception();
@@ -302,10 +394,14 @@ public:
     }
 
     // Returns true if this genome and a_G are compatible (belong in the same species)
-    bool IsCompatibleWith(Genome& a_G, Parameters& a_Parameters);
+    bool IsCompatibleWith(const Genome& a_G, const Parameters& a_Parameters) const;
 
     // returns the absolute compatibility distance between this genome and a_G
-    double CompatibilityDistance(Genome &a_G, Parameters& a_Parameters);
+    double CompatibilityDistance(const Genome &a_G, const Parameters& a_Parameters) const;
+
+    // Same, but stops as soon as the distance is known to be above a_Limit.
+    // Then the returned value is only a partial distance, but still above a_Limit.
+    double CompatibilityDistance(const Genome &a_G, const Parameters& a_Parameters, double a_Limit) const;
 
 
 
@@ -366,7 +462,7 @@ public:
     // If the bool is true, then the genes are averaged
     // Disjoint and excess genes are inherited from the fittest parent
     // If fitness is equal, the smaller genome is assumed to be the better one
-    Genome Mate(Genome& a_dad, bool a_averagemating, bool a_interspecies, RNG& a_RNG);
+    Genome Mate(const Genome& a_dad, bool a_averagemating, bool a_interspecies, RNG& a_RNG) const;
 
 
     //////////
@@ -408,6 +504,9 @@ public:
         ar & m_OffspringAmount;
         ar & m_Evaluated;
         //ar & m_PhenotypeBehavior; // todo: think about how we will handle the behaviors with pickle
+
+        if (Archive::is_loading::value)
+            RebuildIndex();
     }
 
     void RemoveDeadEnd(ConnectionSet & a_connections, std::map<uint, Neuron> & a_neurons);
@@ -72,11 +72,11 @@ void InnovationDatabase::Init(int a_LastInnovationNum, int a_LastNeuronID)
 // Initializes a database from a given genome
 void InnovationDatabase::Init(const Genome& a_Genome)
 {
-    m_Innovations.clear();
+    Flush();
     for(unsigned int i=0; i<a_Genome.NumLinks(); i++)
     {
         Innovation t_innov( a_Genome.GetLinkByIndex(i).InnovationID(), NEW_LINK, a_Genome.GetLinkByIndex(i).FromNeuronID(), a_Genome.GetLinkByIndex(i).ToNeuronID(), NONE, -1);
-        m_Innovations.push_back(t_innov);
+        AddInnovation(t_innov);
     }
 
     m_NextNeuronID = a_Genome.GetLastNeuronID();
@@ -86,7 +86,7 @@ void InnovationDatabase::Init(const Genome& a_Genome)
 
 void InnovationDatabase::Init(std::ifstream& a_DataFile)
 {
-    m_Innovations.clear();
+    Flush();
     m_NextInnovationNum = 0;
     m_NextNeuronID = 0;
 
@@ -123,7 +123,7 @@ void InnovationDatabase::Init(std::ifstream& a_DataFile)
             a_DataFile >> t_neurontype;
             a_DataFile >> t_nid;
 
-            m_Innovations.push_back( Innovation(t_id, static_cast<InnovationType>(t_innovtype), t_from, t_to, static_cast<NeuronType>(t_neurontype), t_nid) );
+            AddInnovation( Innovation(t_id, static_cast<InnovationType>(t_innovtype), t_from, t_to, static_cast<NeuronType>(t_neurontype), t_nid) );
         }
 
     }
@@ -157,18 +157,13 @@ int InnovationDatabase::CheckInnovation(int a_In, int a_Out, InnovationType a_Ty
     ASSERT((a_In > 0) && (a_Out > 0));
     ASSERT((a_Type == NEW_NEURON) || (a_Type == NEW_LINK));
 
-    // search the list for a match
-    for(unsigned int i=0; i < m_Innovations.size(); i++)
-    {
-        if ((m_Innovations[i].FromNeuronID() == a_In) && (m_Innovations[i].ToNeuronID() == a_Out) && (m_Innovations[i].InnovType() == a_Type))
-        {
-            // match found?
-            return m_Innovations[i].ID();
-        }
-    }
+    const std::vector<int>* t_idxs = FindInnovations(a_In, a_Out, a_Type);
 
     // not found
-    return -1;
+    if (t_idxs == NULL)
+        return -1;
+
+    return m_Innovations[t_idxs->front()].ID();
 }
 
 
@@ -176,19 +171,14 @@ int InnovationDatabase::CheckLastInnovation(int a_In, int a_Out, InnovationType
 {
     ASSERT((a_In > 0) && (a_Out > 0));
     ASSERT((a_Type == NEW_NEURON) || (a_Type == NEW_LINK));
-    int t_ID = -1;
 
-    // search the list for a match
-    for(unsigned int i=0; i < m_Innovations.size(); i++)
-    {
-        if ((m_Innovations[i].FromNeuronID() == a_In) && (m_Innovations[i].ToNeuronID() == a_Out) && (m_Innovations[i].InnovType() == a_Type))
-        {
-            // match found?
-            t_ID = m_Innovations[i].ID();
-        }
-    }
+    const std::vector<int>* t_idxs = FindInnovations(a_In, a_Out, a_Type);
+
+    // not found
+    if (t_idxs == NULL)
+        return -1;
 
-    return t_ID;
+    return m_Innovations[t_idxs->back()].ID();
 }
 
 
@@ -198,20 +188,12 @@ std::vector<int> InnovationDatabase::CheckAllInnovations(int a_In, int a_Out, In
     ASSERT((a_In > 0) && (a_Out > 0));
     ASSERT((a_Type == NEW_NEURON) || (a_Type == NEW_LINK));
 
-    std::vector<int> t_idxs;
-    t_idxs.clear();
+    const std::vector<int>* t_idxs = FindInnovations(a_In, a_Out, a_Type);
 
-    // search the list for a match
-    for(unsigned int i=0; i < m_Innovations.size(); i++)
-    {
-        if ((m_Innovations[i].FromNeuronID() == a_In) && (m_Innovations[i].ToNeuronID() == a_Out) && (m_Innovations[i].InnovType() == a_Type))
-        {
-            // match found?
-            t_idxs.push_back( i );
-        }
-    }
+    if (t_idxs == NULL)
+        return std::vector<int>();
 
-    return t_idxs;
+    return *t_idxs;
 }
 
 
@@ -222,36 +204,26 @@ int InnovationDatabase::FindNeuronID(int a_In, int a_Out) const
 {
     ASSERT((a_In > 0) && (a_Out > 0));
 
-    // search the list for a match
-    for(unsigned int i=0; i < m_Innovations.size(); i++)
-    {
-        if ((m_Innovations[i].FromNeuronID() == a_In) && (m_Innovations[i].ToNeuronID() == a_Out) && (m_Innovations[i].InnovType() == NEW_NEURON))
-        {
-            // match found?
-            return m_Innovations[i].NeuronID();
-        }
-    }
+    const std::vector<int>* t_idxs = FindInnovations(a_In, a_Out, NEW_NEURON);
 
     // Not found
-    return -1;
+    if (t_idxs == NULL)
+        return -1;
+
+    return m_Innovations[t_idxs->front()].NeuronID();
 }
 
 int InnovationDatabase::FindLastNeuronID(int a_In, int a_Out) const
 {
     ASSERT((a_In > 0) && (a_Out > 0));
-    int t_ID = -1;
 
-    // search the list for a match
-    for(unsigned int i=0; i < m_Innovations.size(); i++)
-    {
-        if ((m_Innovations[i].FromNeuronID() == a_In) && (m_Innovations[i].ToNeuronID() == a_Out) && (m_Innovations[i].InnovType() == NEW_NEURON))
-        {
-            // match found?
-            t_ID = m_Innovations[i].NeuronID();
-        }
-    }
+    const std::vector<int>* t_idxs = FindInnovations(a_In, a_Out, NEW_NEURON);
+
+    // Not found
+    if (t_idxs == NULL)
+        return -1;
 
-    return t_ID;
+    return m_Innovations[t_idxs->back()].NeuronID();
 }
 
 
@@ -261,7 +233,7 @@ int InnovationDatabase::AddLinkInnovation(int a_In, int a_Out)
 {
     ASSERT((a_In > 0) && (a_Out > 0));
 
-    m_Innovations.push_back( Innovation(m_NextInnovationNum, NEW_LINK, a_In, a_Out, NONE, -1) );
+    AddInnovation( Innovation(m_NextInnovationNum, NEW_LINK, a_In, a_Out, NONE, -1) );
     m_NextInnovationNum++;
 
     return (m_NextInnovationNum - 1);
@@ -279,7 +251,7 @@ int InnovationDatabase::AddNeuronInnovation(int a_In, int a_Out, NeuronType a_NT
     ASSERT((a_In > 0) && (a_Out > 0));
     ASSERT(!((a_NType == INPUT) || (a_NType == BIAS) || (a_NType == OUTPUT)));
 
-    m_Innovations.push_back( Innovation(m_NextInnovationNum, NEW_NEURON, a_In, a_Out, a_NType, m_NextNeuronID) );
+    AddInnovation( Innovation(m_NextInnovationNum, NEW_NEURON, a_In, a_Out, a_NType, m_NextNeuronID) );
     m_NextInnovationNum++;
     m_NextNeuronID++;
 
@@ -293,6 +265,27 @@ int InnovationDatabase::AddNeuronInnovation(int a_In, int a_Out, NeuronType a_NT
 void InnovationDatabase::Flush()
 {
     m_Innovations.clear();
+    m_Index.clear();
+}
+
+
+// Appends an innovation to the list and the index
+void InnovationDatabase::AddInnovation(const Innovation& a_Innov)
+{
+    m_Index[IndexKey(a_Innov.FromNeuronID(), a_Innov.ToNeuronID(), a_Innov.InnovType())].push_back(static_cast<int>(m_Innovations.size()));
+    m_Innovations.push_back(a_Innov);
+}
+
+
+// Returns the indexes of the matching innovations or NULL if there are none
+const std::vector<int>* InnovationDatabase::FindInnovations(int a_In, int a_Out, InnovationType a_Type) const
+{
+    std::unordered_map< unsigned long long, std::vector<int> >::const_iterator t_it = m_Index.find(IndexKey(a_In, a_Out, a_Type));
+
+    if (t_it == m_Index.end())
+        return NULL;
+
+    return &(t_it->second);
 }
 
 
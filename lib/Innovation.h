@@ -32,6 +32,7 @@
 
 #include <vector>
 #include <fstream>
+#include <unordered_map>
 
 #include "Genes.h"
 #include "Genome.h"
@@ -76,6 +77,24 @@ private:
     int m_NeuronID;
     NeuronType m_NeuronType;
 
+    // Only used when loading from an archive
+    Innovation():
+        m_ID(0), m_InnovType(NEW_NEURON), m_FromNeuronID(0), m_ToNeuronID(0), m_NeuronID(0), m_NeuronType(NONE)
+    {
+    }
+
+    friend class boost::serialization::access;
+    template<class Archive>
+    void serialize(Archive & ar, const unsigned int version)
+    {
+        ar & m_ID;
+        ar & m_InnovType;
+        ar & m_FromNeuronID;
+        ar & m_ToNeuronID;
+        ar & m_NeuronID;
+        ar & m_NeuronType;
+    }
+
 public:
 
     ////////////////////////////
@@ -144,9 +163,26 @@ private:
     // The list of innovations
     std::vector<Innovation> m_Innovations;
 
+    // (from, to, type) -> indexes in m_Innovations of the matching innovations,
+    // in the order they were added
+    std::unordered_map< unsigned long long, std::vector<int> > m_Index;
+
     int m_NextNeuronID;
     int m_NextInnovationNum;
 
+    static unsigned long long IndexKey(int a_In, int a_Out, InnovationType a_Type)
+    {
+        return (static_cast<unsigned long long>(static_cast<unsigned int>(a_In)) << 33) |
+               (static_cast<unsigned long long>(static_cast<unsigned int>(a_Out)) << 1) |
+               static_cast<unsigned long long>(a_Type);
+    }
+
+    // Appends an innovation to the list and the index
+    void AddInnovation(const Innovation& a_Innov);
+
+    // Returns the indexes of the matching innovations or NULL if there are none
+    const std::vector<int>* FindInnovations(int a_In, int a_Out, InnovationType a_Type) const;
+
 public:
 
     ////////////////////////////
@@ -212,6 +248,25 @@ public:
 
     // Saves the database to an already opened file
     void Save(FILE* a_file);
+
+private:
+    friend class boost::serialization::access;
+    template<class Archive>
+    void serialize(Archive & ar, const unsigned int version)
+    {
+        ar & m_NextNeuronID;
+        ar & m_NextInnovationNum;
+        ar & m_Innovations;
+
+        if (Archive::is_loading::value)
+        {
+            m_Index.clear();
+            for(unsigned int i=0; i<m_Innovations.size(); i++)
+            {
+                m_Index[IndexKey(m_Innovations[i].FromNeuronID(), m_Innovations[i].ToNeuronID(), m_Innovations[i].InnovType())].push_back(i);
+            }
+        }
+    }
 };
 
 
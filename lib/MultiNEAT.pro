@@ -4,7 +4,7 @@ SOURCES += *.cpp \
 HEADERS += *.h \
     SubstrateBase.h \
     Const.h \
-    QuadTree.h
+    PointIndex.h
 TEMPLATE = lib
 CONFIG += c++11
 CONFIG -= qt
@@ -35,7 +35,11 @@
 #include <sstream>
 #include <string>
 #include <iostream>
+#include <algorithm>
+#include <stdint.h>
+#include <string.h>
 #include "NeuralNetwork.h"
+#include "ActivationKernels.h"
 #include "Assert.h"
 #include "Utils.h"
 #include <boost/format.hpp>
@@ -46,105 +50,6 @@
 namespace NEAT
 {
 
-/////////////////////////////////////
-// The set of activation functions //
-/////////////////////////////////////
-
-
-inline double af_sigmoid_unsigned(double aX, double aSlope, double aShift)
-{
-    return 1.0 / (1.0 + exp( - aSlope * aX - aShift));
-}
-
-inline double af_sigmoid_signed(double aX, double aSlope, double aShift)
-{
-    double tY = af_sigmoid_unsigned(aX, aSlope, aShift);
-    return (tY - 0.5) * 2.0;
-}
-
-
-inline double af_tanh(double aX, double aSlope, double aShift)
-{
-    return tanh(aX * aSlope);
-}
-
-inline double af_tanh_cubic(double aX, double aSlope, double aShift)
-{
-    return tanh(aX * aX * aX * aSlope);
-}
-
-inline double af_step_signed(double aX, double aShift)
-{
-    double tY;
-    if (aX > aShift)
-    {
-        tY = 1.0;
-    }
-    else
-    {
-        tY = -1.0;
-    }
-
-    return tY;
-}
-
-inline double af_step_unsigned(double aX, double aShift)
-{
-    if (aX > aShift)
-    {
-        return 1.0;
-    }
-    else
-    {
-        return 0.0;
-    }
-}
-
-inline double af_gauss_signed(double aX, double aSlope, double aShift)
-{
-    double tY = exp( - aSlope * aX * aX + aShift);
-    return (tY-0.5)*2.0;
-}
-
-inline double af_gauss_unsigned(double aX, double aSlope, double aShift)
-{
-    return exp( - aSlope * aX * aX + aShift);
-}
-
-inline double af_abs(double aX, double aShift)
-{
-    return ((aX + aShift)< 0.0)? -(aX + aShift): (aX + aShift);
-}
-
-inline double af_sine_signed(double aX, double aFreq, double aShift)
-{
-    aFreq = 3.141592;
-    return sin(aX * aFreq + aShift);
-}
-
-inline double af_sine_unsigned(double aX, double aFreq, double aShift)
-{
-    double tY = sin((aX * aFreq + aShift) );
-    return (tY + 1.0) / 2.0;
-}
-
-inline double af_square_signed(double aX, double aHighPulseSize, double aLowPulseSize)
-{
-    return 0.0;    // TODO
-}
-
-inline double af_square_unsigned(double aX, double aHighPulseSize, double aLowPulseSize)
-{
-    return 0.0;    // TODO
-}
-
-inline double af_linear(double aX, double aShift)
-{
-    return (aX + aShift);
-}
-
-
-
 double unsigned_sigmoid_derivative(double x)
 {
     return x * (1 - x);
@@ -159,7 +64,7 @@ double tanh_derivative(double x)
 // Neural network class implementation
 ///////////////////////////////////////
 NeuralNetwork::NeuralNetwork(bool a_Minimal):
-    m_Depth(0), is_depth_ready(false)
+    m_Depth(0), is_depth_ready(false), m_plan_ready(false), m_fast_activation(false)
 {
     if (!a_Minimal)
     {
@@ -257,7 +162,7 @@ NeuralNetwork::NeuralNetwork(bool a_Minimal):
 }
 
 NeuralNetwork::NeuralNetwork():
-    m_Depth(0), is_depth_ready(false)
+    m_Depth(0), is_depth_ready(false), m_plan_ready(false), m_fast_activation(false)
 {
     // an empty network
     m_num_inputs = m_num_outputs = 0;
@@ -296,283 +201,490 @@ void NeuralNetwork::InitRTRLMatrix()
     }
 }
 
-void NeuralNetwork::ActivateFast()
+void NeuralNetwork::Compile()
 {
-    // Loop connections. Calculate each connection's output signal.
+    m_plan.Clear();
+
+    // connections
+    m_plan.m_source.reserve(m_connections.size());
+    m_plan.m_target.reserve(m_connections.size());
+    m_plan.m_weight.reserve(m_connections.size());
     for (unsigned int i = 0; i < m_connections.size(); i++)
     {
-        m_connections[i].m_signal =
-                m_neurons[m_connections[i].m_source_neuron_idx].m_activation
-                        * m_connections[i].m_weight;
+        m_plan.m_source.push_back(m_connections[i].m_source_neuron_idx);
+        m_plan.m_target.push_back(m_connections[i].m_target_neuron_idx);
+        m_plan.m_weight.push_back(m_connections[i].m_weight);
     }
-    // Loop the connections again. This time add the signals to the target neurons.
-    // This will largely require out of order memory writes. This is the one loop where
-    // this will happen.
-    for (unsigned int i = 0; i < m_connections.size(); i++)
+
+    // group the non-input neurons by activation function
+    // the stable sort keeps the original order inside a group
+    std::vector<unsigned int> t_order;
+    for (unsigned int i = m_num_inputs; i < m_neurons.size(); i++)
     {
-        m_neurons[m_connections[i].m_target_neuron_idx].m_activesum +=
-                m_connections[i].m_signal;
+        t_order.push_back(i);
     }
-    // Now loop nodes_activesums, pass the signals through the activation function
-    // and store the result back to nodes_activations
-    // also skip inputs since they do not get an activation
-    for (unsigned int i = m_num_inputs; i < m_neurons.size(); i++)
+    std::stable_sort(t_order.begin(), t_order.end(),
+                     [this](unsigned int a, unsigned int b)
+                     {
+                         return m_neurons[a].m_activation_function_type <
+                                m_neurons[b].m_activation_function_type;
+                     });
+
+    for (unsigned int k = 0; k < t_order.size(); k++)
     {
-        double x = m_neurons[i].m_activesum;
-        m_neurons[i].m_activesum = 0;
-        // Apply the activation function
-        double y = 0.0;
-        y = af_sigmoid_unsigned(x, m_neurons[i].m_a, m_neurons[i].m_b);
-        m_neurons[i].m_activation = y;
+        const Neuron& t_n = m_neurons[t_order[k]];
+
+        if ((k == 0) || (t_n.m_activation_function_type != m_plan.m_group_type.back()))
+        {
+            m_plan.m_group_type.push_back(t_n.m_activation_function_type);
+            m_plan.m_group_start.push_back(k);
+        }
+
+        m_plan.m_neuron_idx.push_back(t_order[k]);
+        m_plan.m_a.push_back(t_n.m_a);
+        m_plan.m_b.push_back(t_n.m_b);
+        m_plan.m_bias.push_back(t_n.m_bias);
+        m_plan.m_timeconst.push_back(t_n.m_timeconst);
     }
+    m_plan.m_group_start.push_back(t_order.size());
+
+    m_plan.m_activation.resize(m_neurons.size());
+    m_plan.m_activesum.resize(m_neurons.size());
+
+    CompileFeedForward();
+    m_plan.m_x.resize(t_order.size());
+    m_plan.m_y.resize(t_order.size());
+
+    m_plan_ready = true;
 }
 
-void NeuralNetwork::Activate()
+void NeuralNetwork::CompileFeedForward()
 {
-    // Loop connections. Calculate each connection's output signal.
-    for (unsigned int i = 0; i < m_connections.size(); i++)
+    const unsigned int t_num_neurons = m_neurons.size();
+
+    // where each neuron ended up in the grouped order
+    std::vector<unsigned int> t_slot(t_num_neurons, 0);
+    for (unsigned int k = 0; k < m_plan.m_neuron_idx.size(); k++)
     {
-        m_connections[i].m_signal =
-                m_neurons[m_connections[i].m_source_neuron_idx].m_activation
-                        * m_connections[i].m_weight;
+        t_slot[m_plan.m_neuron_idx[k]] = k;
     }
-    // Loop the connections again. This time add the signals to the target neurons.
-    // This will largely require out of order memory writes. This is the one loop where
-    // this will happen.
-    for (unsigned int i = 0; i < m_connections.size(); i++)
+
+    // Incoming links per neuron. Links into inputs are ignored, inputs are never computed.
+    // Only links between non-input neurons constrain the order.
+    std::vector< std::vector<unsigned int> > t_incoming(t_num_neurons);
+    std::vector< std::vector<unsigned int> > t_outgoing(t_num_neurons);
+    std::vector<unsigned int> t_indegree(t_num_neurons, 0);
+    for (unsigned int i = 0; i < m_plan.m_source.size(); i++)
+    {
+        unsigned int t_from = m_plan.m_source[i];
+        unsigned int t_to = m_plan.m_target[i];
+
+        if (t_to < m_num_inputs)
+            continue;
+
+        t_incoming[t_to].push_back(i);
+        if (t_from >= m_num_inputs)
+        {
+            t_outgoing[t_from].push_back(t_to);
+            t_indegree[t_to]++;
+        }
+    }
+
+    // Kahn's algorithm, ties broken by neuron index so the order is deterministic
+    std::vector<unsigned int> t_order;
+    for (unsigned int i = m_num_inputs; i < t_num_neurons; i++)
     {
-        m_neurons[m_connections[i].m_target_neuron_idx].m_activesum +=
-                m_connections[i].m_signal;
+        if (t_indegree[i] == 0)
+            t_order.push_back(i);
     }
-    // Now loop nodes_activesums, pass the signals through the activation function
-    // and store the result back to nodes_activations
-    // also skip inputs since they do not get an activation
-    for (unsigned int i = m_num_inputs; i < m_neurons.size(); i++)
-        CalculateNeuronActivation(i);
+    for (unsigned int k = 0; k < t_order.size(); k++)
+    {
+        const std::vector<unsigned int>& t_out = t_outgoing[t_order[k]];
+        for (unsigned int j = 0; j < t_out.size(); j++)
+        {
+            if (--t_indegree[t_out[j]] == 0)
+                t_order.push_back(t_out[j]);
+        }
+    }
+
+    // if some neurons could not be ordered, there is a loop somewhere
+    m_plan.m_feed_forward = (t_order.size() == m_plan.m_neuron_idx.size());
+    if (!m_plan.m_feed_forward)
+        return;
+
+    m_plan.m_ff_start.push_back(0);
+    for (unsigned int k = 0; k < t_order.size(); k++)
+    {
+        unsigned int t_n = t_order[k];
+        m_plan.m_ff_neuron_idx.push_back(t_n);
+        m_plan.m_ff_slot.push_back(t_slot[t_n]);
+        m_plan.m_ff_type.push_back(m_neurons[t_n].m_activation_function_type);
+
+        for (unsigned int j = 0; j < t_incoming[t_n].size(); j++)
+        {
+            m_plan.m_ff_source.push_back(m_plan.m_source[t_incoming[t_n][j]]);
+            m_plan.m_ff_weight.push_back(m_plan.m_weight[t_incoming[t_n][j]]);
+        }
+        m_plan.m_ff_start.push_back(m_plan.m_ff_source.size());
+    }
+}
+
+void NeuralNetwork::EnsurePlan()
+{
+    // a cheap sanity check in case the neurons/connections were replaced from outside
+    if ((!m_plan_ready) ||
+        (m_plan.m_activation.size() != m_neurons.size()) ||
+        (m_plan.m_source.size() != m_connections.size()))
+    {
+        Compile();
+    }
+}
+
+void NeuralNetwork::PlanPropagate()
+{
+    const unsigned int t_num_neurons = m_neurons.size();
+    const unsigned int t_num_connections = m_plan.m_source.size();
+
+    double* t_activation = m_plan.m_activation.data();
+    double* t_activesum = m_plan.m_activesum.data();
+    const unsigned int* t_source = m_plan.m_source.data();
+    const unsigned int* t_target = m_plan.m_target.data();
+    const double* t_weight = m_plan.m_weight.data();
 
+    // Gather the current activations. The sums are always cleared after an activation.
+    for (unsigned int i = 0; i < t_num_neurons; i++)
+    {
+        t_activation[i] = m_neurons[i].m_activation;
+        t_activesum[i] = 0.0;
+    }
+
+    // Loop connections. Add each connection's output signal to the target neuron.
+    // The activations are not touched until all signals are summed,
+    // so this is the same as computing all signals first.
+    for (unsigned int i = 0; i < t_num_connections; i++)
+    {
+        t_activesum[t_target[i]] += t_activation[t_source[i]] * t_weight[i];
+    }
+}
+
+void NeuralNetwork::ApplyActivation(ActivationFunction a_type, const double* x, const double* a,
+                                    const double* b, double* y, unsigned int n)
+{
+    if (m_fast_activation)
+        af_apply_fast(a_type, x, a, b, y, n);
+    else
+        af_apply(a_type, x, a, b, y, n);
+}
+
+void NeuralNetwork::PlanActivate()
+{
+    const unsigned int* t_start = m_plan.m_group_start.data();
+    const double* t_x = m_plan.m_x.data();
+    const double* t_a = m_plan.m_a.data();
+    const double* t_b = m_plan.m_b.data();
+    double* t_y = m_plan.m_y.data();
+
+    // one dispatch per group of neurons sharing an activation function
+    for (unsigned int g = 0; g < m_plan.m_group_type.size(); g++)
+    {
+        ApplyActivation(m_plan.m_group_type[g],
+                        t_x + t_start[g], t_a + t_start[g], t_b + t_start[g], t_y + t_start[g],
+                        t_start[g + 1] - t_start[g]);
+    }
+
+    // scatter the results back to the neurons
+    for (unsigned int k = 0; k < m_plan.m_neuron_idx.size(); k++)
+    {
+        Neuron& t_n = m_neurons[m_plan.m_neuron_idx[k]];
+        t_n.m_activation = t_y[k];
+        t_n.m_activesum = 0;
+    }
+}
+
+void NeuralNetwork::ActivateFast()
+{
+    EnsurePlan();
+    PlanPropagate();
+
+    // assumes unsigned sigmoids everywhere, so the groups are ignored
+    const unsigned int t_n = m_plan.m_neuron_idx.size();
+    for (unsigned int k = 0; k < t_n; k++)
+    {
+        m_plan.m_x[k] = m_plan.m_activesum[m_plan.m_neuron_idx[k]];
+    }
+    ApplyActivation(UNSIGNED_SIGMOID, m_plan.m_x.data(), m_plan.m_a.data(), m_plan.m_b.data(),
+                    m_plan.m_y.data(), t_n);
+
+    for (unsigned int k = 0; k < t_n; k++)
+    {
+        Neuron& t_neuron = m_neurons[m_plan.m_neuron_idx[k]];
+        t_neuron.m_activation = m_plan.m_y[k];
+        t_neuron.m_activesum = 0;
+    }
+}
+
+void NeuralNetwork::Activate()
+{
+    EnsurePlan();
+    PlanPropagate();
+
+    for (unsigned int k = 0; k < m_plan.m_neuron_idx.size(); k++)
+    {
+        m_plan.m_x[k] = m_plan.m_activesum[m_plan.m_neuron_idx[k]];
+    }
+
+    PlanActivate();
 }
 
 void NeuralNetwork::CalculateNeuronActivation(size_t i){
     double x = m_neurons[i].m_activesum;
     m_neurons[i].m_activesum = 0;
     // Apply the activation function
-    double y = 0.0;
-    switch (m_neurons[i].m_activation_function_type)
-    {
-    case SIGNED_SIGMOID:
-        y = af_sigmoid_signed(x, m_neurons[i].m_a, m_neurons[i].m_b);
-        break;
-    case UNSIGNED_SIGMOID:
-        y = af_sigmoid_unsigned(x, m_neurons[i].m_a, m_neurons[i].m_b);
-        break;
-    case TANH:
-        y = af_tanh(x, m_neurons[i].m_a, m_neurons[i].m_b);
-        break;
-    case TANH_CUBIC:
-        y = af_tanh_cubic(x, m_neurons[i].m_a, m_neurons[i].m_b);
-        break;
-    case SIGNED_STEP:
-        y = af_step_signed(x, m_neurons[i].m_b);
-        break;
-    case UNSIGNED_STEP:
-        y = af_step_unsigned(x, m_neurons[i].m_b);
-        break;
-    case SIGNED_GAUSS:
-        y = af_gauss_signed(x, m_neurons[i].m_a, m_neurons[i].m_b);
-        break;
-    case UNSIGNED_GAUSS:
-        y = af_gauss_unsigned(x, m_neurons[i].m_a, m_neurons[i].m_b);
-        break;
-    case ABS:
-        y = af_abs(x, m_neurons[i].m_b);
-        break;
-    case SIGNED_SINE:
-        y = af_sine_signed(x, m_neurons[i].m_a, m_neurons[i].m_b);
-        break;
-    case UNSIGNED_SINE:
-        y = af_sine_unsigned(x, m_neurons[i].m_a, m_neurons[i].m_b);
-        break;
-    case SIGNED_SQUARE:
-        y = af_square_signed(x, m_neurons[i].m_a, m_neurons[i].m_b);
-        break;
-    case UNSIGNED_SQUARE:
-        y = af_square_unsigned(x, m_neurons[i].m_a, m_neurons[i].m_b);
-        break;
-    case LINEAR:
-        y = af_linear(x, m_neurons[i].m_b);
-        break;
-    default:
-        y = af_sigmoid_unsigned(x, m_neurons[i].m_a, m_neurons[i].m_b);
-        break;
-    }
-    m_neurons[i].m_activation = y;
+    m_neurons[i].m_activation = af_eval(m_neurons[i].m_activation_function_type, x,
+                                        m_neurons[i].m_a, m_neurons[i].m_b);
 }
 
-void NeuralNetwork::ActivateUseInternalBias()
+bool NeuralNetwork::IsFeedForward()
 {
-    // Loop connections. Calculate each connection's output signal.
-    for (unsigned int i = 0; i < m_connections.size(); i++)
+    EnsurePlan();
+    return m_plan.m_feed_forward;
+}
+
+void NeuralNetwork::ActivateFeedForward()
+{
+    EnsurePlan();
+
+    // loops need the activation to be repeated until the signals settle
+    if (!m_plan.m_feed_forward)
     {
-        m_connections[i].m_signal =
-                m_neurons[m_connections[i].m_source_neuron_idx].m_activation
-                        * m_connections[i].m_weight;
+        unsigned int t_depth = CalculateDepth();
+        for (unsigned int d = 0; d < t_depth; d++)
+            Activate();
+        return;
     }
-    // Loop the connections again. This time add the signals to the target neurons.
-    // This will largely require out of order memory writes. This is the one loop where
-    // this will happen.
-    for (unsigned int i = 0; i < m_connections.size(); i++)
+
+    double* t_activation = m_plan.m_activation.data();
+    const unsigned int* t_start = m_plan.m_ff_start.data();
+    const unsigned int* t_source = m_plan.m_ff_source.data();
+    const double* t_weight = m_plan.m_ff_weight.data();
+
+    for (unsigned int i = 0; i < m_num_inputs; i++)
     {
-        m_neurons[m_connections[i].m_target_neuron_idx].m_activesum +=
-                m_connections[i].m_signal;
+        t_activation[i] = m_neurons[i].m_activation;
     }
-    // Now loop nodes_activesums, pass the signals through the activation function
-    // and store the result back to nodes_activations
-    // also skip inputs since they do not get an activation
-    for (unsigned int i = m_num_inputs; i < m_neurons.size(); i++)
+
+    // Every neuron's sources come before it in the order, so one sweep is enough
+    for (unsigned int k = 0; k < m_plan.m_ff_neuron_idx.size(); k++)
     {
-        double x = m_neurons[i].m_activesum + m_neurons[i].m_bias;
-        m_neurons[i].m_activesum = 0;
-        // Apply the activation function
-        double y = 0.0;
-        switch (m_neurons[i].m_activation_function_type)
+        double t_sum = 0.0;
+        for (unsigned int j = t_start[k]; j < t_start[k + 1]; j++)
         {
-        case SIGNED_SIGMOID:
-            y = af_sigmoid_signed(x, m_neurons[i].m_a, m_neurons[i].m_b);
-            break;
-        case UNSIGNED_SIGMOID:
-            y = af_sigmoid_unsigned(x, m_neurons[i].m_a, m_neurons[i].m_b);
-            break;
-        case TANH:
-            y = af_tanh(x, m_neurons[i].m_a, m_neurons[i].m_b);
-            break;
-        case TANH_CUBIC:
-            y = af_tanh_cubic(x, m_neurons[i].m_a, m_neurons[i].m_b);
-            break;
-        case SIGNED_STEP:
-            y = af_step_signed(x, m_neurons[i].m_b);
-            break;
-        case UNSIGNED_STEP:
-            y = af_step_unsigned(x, m_neurons[i].m_b);
-            break;
-        case SIGNED_GAUSS:
-            y = af_gauss_signed(x, m_neurons[i].m_a, m_neurons[i].m_b);
-            break;
-        case UNSIGNED_GAUSS:
-            y = af_gauss_unsigned(x, m_neurons[i].m_a, m_neurons[i].m_b);
-            break;
-        case ABS:
-            y = af_abs(x, m_neurons[i].m_b);
-            break;
-        case SIGNED_SINE:
-            y = af_sine_signed(x, m_neurons[i].m_a, m_neurons[i].m_b);
-            break;
-        case UNSIGNED_SINE:
-            y = af_sine_unsigned(x, m_neurons[i].m_a, m_neurons[i].m_b);
-            break;
-        case SIGNED_SQUARE:
-            y = af_square_signed(x, m_neurons[i].m_a, m_neurons[i].m_b);
-            break;
-        case UNSIGNED_SQUARE:
-            y = af_square_unsigned(x, m_neurons[i].m_a, m_neurons[i].m_b);
-            break;
-        case LINEAR:
-            y = af_linear(x, m_neurons[i].m_b);
-            break;
-        default:
-            y = af_sigmoid_unsigned(x, m_neurons[i].m_a, m_neurons[i].m_b);
-            break;
+            t_sum += t_activation[t_source[j]] * t_weight[j];
         }
-        m_neurons[i].m_activation = y;
-    }
 
+        unsigned int t_slot = m_plan.m_ff_slot[k];
+        double y = af_eval(m_plan.m_ff_type[k], t_sum, m_plan.m_a[t_slot], m_plan.m_b[t_slot]);
+        t_activation[m_plan.m_ff_neuron_idx[k]] = y;
+
+        Neuron& t_n = m_neurons[m_plan.m_ff_neuron_idx[k]];
+        t_n.m_activation = y;
+        t_n.m_activesum = 0;
+    }
 }
 
+void NeuralNetwork::ActivateFeedForward(const double* a_Inputs, double* a_Outputs)
+{
+    EnsurePlan();
+    ASSERT(m_plan.m_feed_forward);
+
+    double* t_activation = m_plan.m_activation.data();
+    const unsigned int* t_start = m_plan.m_ff_start.data();
+    const unsigned int* t_source = m_plan.m_ff_source.data();
+    const double* t_weight = m_plan.m_ff_weight.data();
 
-void NeuralNetwork::ActivateLeaky(double a_dtime)
+    for (unsigned int i = 0; i < m_num_inputs; i++)
+    {
+        t_activation[i] = a_Inputs[i];
+    }
+
+    for (unsigned int k = 0; k < m_plan.m_ff_neuron_idx.size(); k++)
+    {
+        double t_sum = 0.0;
+        for (unsigned int j = t_start[k]; j < t_start[k + 1]; j++)
+        {
+            t_sum += t_activation[t_source[j]] * t_weight[j];
+        }
+
+        unsigned int t_slot = m_plan.m_ff_slot[k];
+        t_activation[m_plan.m_ff_neuron_idx[k]] = af_eval(m_plan.m_ff_type[k], t_sum, m_plan.m_a[t_slot], m_plan.m_b[t_slot]);
+    }
+
+    for (unsigned int i = 0; i < m_num_outputs; i++)
+    {
+        a_Outputs[i] = t_activation[i + m_num_inputs];
+    }
+}
+
+void NeuralNetwork::ActivateBatch(const std::vector<double>& a_Inputs, std::vector<double>& a_Outputs)
 {
-    // Loop connections. Calculate each connection's output signal.
-    for (unsigned int i = 0; i < m_connections.size(); i++)
+    if ((m_num_inputs == 0) || (a_Inputs.size() % m_num_inputs != 0))
+        throwWrongSize(a_Inputs.size(), m_num_inputs);
+
+    EnsurePlan();
+
+    const unsigned int t_num_samples = a_Inputs.size() / m_num_inputs;
+    const unsigned int t_num_neurons = m_neurons.size();
+    const unsigned int N = t_num_samples;
+
+    std::vector<double>& t_act = m_plan.m_batch_activation;
+    t_act.assign(t_num_neurons * N, 0.0);
+
+    // the kernels take per-sample parameters, these are filled for each neuron
+    std::vector<double>& t_a = m_plan.m_batch_a;
+    std::vector<double>& t_b = m_plan.m_batch_b;
+    t_a.resize(N);
+    t_b.resize(N);
+
+    // transpose the inputs in
+    for (unsigned int s = 0; s < N; s++)
     {
-        m_connections[i].m_signal =
-                m_neurons[m_connections[i].m_source_neuron_idx].m_activation
-                        * m_connections[i].m_weight;
+        for (unsigned int i = 0; i < m_num_inputs; i++)
+        {
+            t_act[i * N + s] = a_Inputs[s * m_num_inputs + i];
+        }
     }
-    // Loop the connections again. This time add the signals to the target neurons.
-    // This will largely require out of order memory writes. This is the one loop where
-    // this will happen.
-    for (unsigned int i = 0; i < m_connections.size(); i++)
+
+    if (m_plan.m_feed_forward)
     {
-        m_neurons[m_connections[i].m_target_neuron_idx].m_activesum +=
-                m_connections[i].m_signal;
+        // one sweep in topological order, each link is visited once for the whole batch
+        std::vector<double>& t_sum = m_plan.m_batch_activesum;
+        t_sum.resize(N);
+        for (unsigned int k = 0; k < m_plan.m_ff_neuron_idx.size(); k++)
+        {
+            std::fill(t_sum.begin(), t_sum.end(), 0.0);
+            for (unsigned int j = m_plan.m_ff_start[k]; j < m_plan.m_ff_start[k + 1]; j++)
+            {
+                const double* t_src = &t_act[m_plan.m_ff_source[j] * N];
+                const double t_w = m_plan.m_ff_weight[j];
+                for (unsigned int s = 0; s < N; s++)
+                {
+                    t_sum[s] += t_src[s] * t_w;
+                }
+            }
+
+            unsigned int t_slot = m_plan.m_ff_slot[k];
+            std::fill(t_a.begin(), t_a.end(), m_plan.m_a[t_slot]);
+            std::fill(t_b.begin(), t_b.end(), m_plan.m_b[t_slot]);
+            ApplyActivation(m_plan.m_ff_type[k], t_sum.data(), t_a.data(), t_b.data(),
+                            &t_act[m_plan.m_ff_neuron_idx[k] * N], N);
+        }
     }
-    // Now we have the leaky integrator step for the neurons
-    for (unsigned int i = m_num_inputs; i < m_neurons.size(); i++)
+    else
     {
-        double t_const = a_dtime / m_neurons[i].m_timeconst;
-        m_neurons[i].m_membrane_potential = (1.0 - t_const)
-                * m_neurons[i].m_membrane_potential
-                + t_const * m_neurons[i].m_activesum;
+        // loops - activate the whole batch as many times as deep
+        std::vector<double>& t_sum = m_plan.m_batch_activesum;
+        unsigned int t_depth = CalculateDepth();
+        for (unsigned int d = 0; d < t_depth; d++)
+        {
+            t_sum.assign(t_num_neurons * N, 0.0);
+            for (unsigned int j = 0; j < m_plan.m_source.size(); j++)
+            {
+                const double* t_src = &t_act[m_plan.m_source[j] * N];
+                double* t_dst = &t_sum[m_plan.m_target[j] * N];
+                const double t_w = m_plan.m_weight[j];
+                for (unsigned int s = 0; s < N; s++)
+                {
+                    t_dst[s] += t_src[s] * t_w;
+                }
+            }
+
+            for (unsigned int g = 0; g < m_plan.m_group_type.size(); g++)
+            {
+                for (unsigned int k = m_plan.m_group_start[g]; k < m_plan.m_group_start[g + 1]; k++)
+                {
+                    unsigned int t_n = m_plan.m_neuron_idx[k];
+                    std::fill(t_a.begin(), t_a.end(), m_plan.m_a[k]);
+                    std::fill(t_b.begin(), t_b.end(), m_plan.m_b[k]);
+                    ApplyActivation(m_plan.m_group_type[g], &t_sum[t_n * N], t_a.data(), t_b.data(),
+                                    &t_act[t_n * N], N);
+                }
+            }
+        }
     }
-    // Now loop nodes_activesums, pass the signals through the activation function
-    // and store the result back to nodes_activations
-    // also skip inputs since they do not get an activation
-    for (unsigned int i = m_num_inputs; i < m_neurons.size(); i++)
+
+    // and the outputs back out
+    a_Outputs.resize(N * m_num_outputs);
+    for (unsigned int s = 0; s < N; s++)
     {
-        double x = m_neurons[i].m_membrane_potential + m_neurons[i].m_bias;
-        m_neurons[i].m_activesum = 0;
-        // Apply the activation function
-        double y = 0.0;
-        switch (m_neurons[i].m_activation_function_type)
+        for (unsigned int o = 0; o < m_num_outputs; o++)
         {
-        case SIGNED_SIGMOID:
-            y = af_sigmoid_signed(x, m_neurons[i].m_a, m_neurons[i].m_b);
-            break;
-        case UNSIGNED_SIGMOID:
-            y = af_sigmoid_unsigned(x, m_neurons[i].m_a, m_neurons[i].m_b);
-            break;
-        case TANH:
-            y = af_tanh(x, m_neurons[i].m_a, m_neurons[i].m_b);
-            break;
-        case TANH_CUBIC:
-            y = af_tanh_cubic(x, m_neurons[i].m_a, m_neurons[i].m_b);
-            break;
-        case SIGNED_STEP:
-            y = af_step_signed(x, m_neurons[i].m_b);
-            break;
-        case UNSIGNED_STEP:
-            y = af_step_unsigned(x, m_neurons[i].m_b);
-            break;
-        case SIGNED_GAUSS:
-            y = af_gauss_signed(x, m_neurons[i].m_a, m_neurons[i].m_b);
-            break;
-        case UNSIGNED_GAUSS:
-            y = af_gauss_unsigned(x, m_neurons[i].m_a, m_neurons[i].m_b);
-            break;
-        case ABS:
-            y = af_abs(x, m_neurons[i].m_b);
-            break;
-        case SIGNED_SINE:
-            y = af_sine_signed(x, m_neurons[i].m_a, m_neurons[i].m_b);
-            break;
-        case UNSIGNED_SINE:
-            y = af_sine_unsigned(x, m_neurons[i].m_a, m_neurons[i].m_b);
-            break;
-        case SIGNED_SQUARE:
-            y = af_square_signed(x, m_neurons[i].m_a, m_neurons[i].m_b);
-            break;
-        case UNSIGNED_SQUARE:
-            y = af_square_unsigned(x, m_neurons[i].m_a, m_neurons[i].m_b);
-            break;
-        case LINEAR:
-            y = af_linear(x, m_neurons[i].m_b);
-            break;
-        default:
-            y = af_sigmoid_unsigned(x, m_neurons[i].m_a, m_neurons[i].m_b);
-            break;
+            a_Outputs[s * m_num_outputs + o] = t_act[(m_num_inputs + o) * N + s];
         }
-        m_neurons[i].m_activation = y;
     }
+}
+
+py::list NeuralNetwork::ActivateBatch_python_list(py::list& a_Inputs)
+{
+    // a list of input lists
+    size_t t_num_samples = py::len(a_Inputs);
+    std::vector<double> t_inputs;
+    t_inputs.reserve(t_num_samples * m_num_inputs);
+    for (size_t s = 0; s < t_num_samples; s++)
+    {
+        py::object t_sample = a_Inputs[s];
+        size_t len = py::len(t_sample);
+        if (len != m_num_inputs)
+            throwWrongSize(len, m_num_inputs);
+
+        for (size_t i = 0; i < len; i++)
+            t_inputs.push_back(py::extract<double>(t_sample[i]));
+    }
+
+    std::vector<double> t_outputs;
+    if (t_num_samples > 0)
+        ActivateBatch(t_inputs, t_outputs);
 
+    py::list t_result;
+    for (size_t s = 0; s < t_num_samples; s++)
+    {
+        py::list t_row;
+        for (unsigned int o = 0; o < m_num_outputs; o++)
+            t_row.append(t_outputs[s * m_num_outputs + o]);
+        t_result.append(t_row);
+    }
+    return t_result;
+}
+
+void NeuralNetwork::ActivateUseInternalBias()
+{
+    EnsurePlan();
+    PlanPropagate();
+
+    for (unsigned int k = 0; k < m_plan.m_neuron_idx.size(); k++)
+    {
+        m_plan.m_x[k] = m_plan.m_activesum[m_plan.m_neuron_idx[k]] + m_plan.m_bias[k];
+    }
+
+    PlanActivate();
+}
+
+
+void NeuralNetwork::ActivateLeaky(double a_dtime)
+{
+    EnsurePlan();
+    PlanPropagate();
+
+    // Now we have the leaky integrator step for the neurons
+    for (unsigned int k = 0; k < m_plan.m_neuron_idx.size(); k++)
+    {
+        Neuron& t_n = m_neurons[m_plan.m_neuron_idx[k]];
+        double t_const = a_dtime / m_plan.m_timeconst[k];
+        t_n.m_membrane_potential = (1.0 - t_const) * t_n.m_membrane_potential
+                + t_const * m_plan.m_activesum[m_plan.m_neuron_idx[k]];
+        m_plan.m_x[k] = t_n.m_membrane_potential + m_plan.m_bias[k];
+    }
+
+    PlanActivate();
 }
 
 void NeuralNetwork::Flush()
@@ -702,6 +814,9 @@ void NeuralNetwork::Adapt(Parameters& a_Parameters)
                 a_Parameters.MaxWeight);
     }
 
+    // the weights changed
+    m_plan_ready = false;
+
 }
 
 int NeuralNetwork::ConnectionExists(uint a_to, uint a_from)
@@ -805,6 +920,7 @@ void NeuralNetwork::RTRL_update_weights()
         m_total_weight_change[i] = 0; // clear this out
     }
     m_total_error = 0;
+    m_plan_ready = false;
 }
 
 void NeuralNetwork::Save(const char* a_filename)
@@ -894,12 +1010,13 @@ bool NeuralNetwork::Load(std::ifstream& a_DataFile)
             a_DataFile >> t_n.m_bias;
             a_DataFile >> t_aftype;
             a_DataFile >> t_n.m_split_y;
-            a_DataFile >> t_n.id;
 
+            // the neurons are saved in order, the id is the index
+            t_n.id = m_neurons.size();
             t_n.m_type = static_cast<NEAT::NeuronType>(t_type);
             t_n.m_activation_function_type = static_cast<NEAT::ActivationFunction>(t_aftype);
 
-            m_neurons[t_n.id] = t_n;
+            AddNeuron(t_n);
         }
 
         // a connection?
@@ -944,6 +1061,225 @@ bool NeuralNetwork::Load(const char *a_filename)
     return Load(t_DataFile);
 }
 
+// The binary format:
+// "MNNB", version, byte order mark, num inputs, num outputs, num neurons, num connections (uint32 each)
+// then the neuron fields, one array each: type, activation function type (int32),
+// A, B, time const, bias, split_y (double)
+// and the connection fields: source, target (uint32), weight (double), recurrent flag (uint8),
+// hebb rate, hebb pre rate (double)
+static const char NN_BINARY_MAGIC[4] = { 'M', 'N', 'N', 'B' };
+static const uint32_t NN_BINARY_VERSION = 1;
+static const uint32_t NN_BINARY_BYTE_ORDER = 0x01020304;
+
+// the size of the arrays of one neuron and of one connection
+static const uint64_t NN_BINARY_NEURON_BYTES = 2 * sizeof(int32_t) + 5 * sizeof(double);
+static const uint64_t NN_BINARY_CONNECTION_BYTES = 2 * sizeof(uint32_t) + 3 * sizeof(double) + sizeof(uint8_t);
+
+template <typename T>
+static bool WriteArray(FILE* a_file, const std::vector<T>& a_data)
+{
+    return a_data.empty() || (fwrite(a_data.data(), sizeof(T), a_data.size(), a_file) == a_data.size());
+}
+
+// The bytes from the current position to the end of the file, -1 if it can't seek
+static long RemainingBytes(FILE* a_file)
+{
+    long t_pos = ftell(a_file);
+    if ((t_pos < 0) || (fseek(a_file, 0, SEEK_END) != 0))
+        return -1;
+
+    long t_end = ftell(a_file);
+    if ((t_end < t_pos) || (fseek(a_file, t_pos, SEEK_SET) != 0))
+        return -1;
+
+    return t_end - t_pos;
+}
+
+template <typename T>
+static bool ReadArray(FILE* a_file, std::vector<T>& a_data, size_t a_size)
+{
+    a_data.resize(a_size);
+    return (a_size == 0) || (fread(a_data.data(), sizeof(T), a_size, a_file) == a_size);
+}
+
+bool NeuralNetwork::SaveBinary(const char* a_filename)
+{
+    FILE* fil = fopen(a_filename, "wb");
+    if (!fil)
+        return false;
+    bool t_result = SaveBinary(fil);
+    // the buffered data is only written by fclose
+    if (fclose(fil) != 0)
+        t_result = false;
+    return t_result;
+}
+
+bool NeuralNetwork::LoadBinary(const char* a_filename)
+{
+    FILE* fil = fopen(a_filename, "rb");
+    if (!fil)
+        return false;
+    bool t_result = LoadBinary(fil);
+    fclose(fil);
+    return t_result;
+}
+
+bool NeuralNetwork::SaveBinary(FILE* a_file)
+{
+    const unsigned int N = m_neurons.size();
+    const unsigned int C = m_connections.size();
+
+    uint32_t t_header[6] = { NN_BINARY_VERSION, NN_BINARY_BYTE_ORDER, m_num_inputs, m_num_outputs, N, C };
+    if ((fwrite(NN_BINARY_MAGIC, 1, sizeof(NN_BINARY_MAGIC), a_file) != sizeof(NN_BINARY_MAGIC)) ||
+        (fwrite(t_header, sizeof(uint32_t), 6, a_file) != 6))
+    {
+        return false;
+    }
+
+    // neurons
+    std::vector<int32_t> t_type(N), t_aftype(N);
+    std::vector<double> t_a(N), t_b(N), t_timeconst(N), t_bias(N), t_split_y(N);
+    for (unsigned int i = 0; i < N; i++)
+    {
+        t_type[i] = static_cast<int32_t>(m_neurons[i].m_type);
+        t_aftype[i] = static_cast<int32_t>(m_neurons[i].m_activation_function_type);
+        t_a[i] = m_neurons[i].m_a;
+        t_b[i] = m_neurons[i].m_b;
+        t_timeconst[i] = m_neurons[i].m_timeconst;
+        t_bias[i] = m_neurons[i].m_bias;
+        t_split_y[i] = m_neurons[i].m_split_y;
+    }
+    bool t_ok = WriteArray(a_file, t_type) &&
+                WriteArray(a_file, t_aftype) &&
+                WriteArray(a_file, t_a) &&
+                WriteArray(a_file, t_b) &&
+                WriteArray(a_file, t_timeconst) &&
+                WriteArray(a_file, t_bias) &&
+                WriteArray(a_file, t_split_y);
+    if (!t_ok)
+        return false;
+
+    // connections
+    std::vector<uint32_t> t_source(C), t_target(C);
+    std::vector<double> t_weight(C), t_hebb_rate(C), t_hebb_pre_rate(C);
+    std::vector<uint8_t> t_recur(C);
+    for (unsigned int i = 0; i < C; i++)
+    {
+        t_source[i] = m_connections[i].m_source_neuron_idx;
+        t_target[i] = m_connections[i].m_target_neuron_idx;
+        t_weight[i] = m_connections[i].m_weight;
+        t_recur[i] = m_connections[i].m_recur_flag ? 1 : 0;
+        t_hebb_rate[i] = m_connections[i].m_hebb_rate;
+        t_hebb_pre_rate[i] = m_connections[i].m_hebb_pre_rate;
+    }
+    return WriteArray(a_file, t_source) &&
+           WriteArray(a_file, t_target) &&
+           WriteArray(a_file, t_weight) &&
+           WriteArray(a_file, t_recur) &&
+           WriteArray(a_file, t_hebb_rate) &&
+           WriteArray(a_file, t_hebb_pre_rate);
+}
+
+bool NeuralNetwork::LoadBinary(FILE* a_file)
+{
+    char t_magic[4];
+    uint32_t t_header[6];
+    if ((fread(t_magic, 1, sizeof(t_magic), a_file) != sizeof(t_magic)) ||
+        (memcmp(t_magic, NN_BINARY_MAGIC, sizeof(t_magic)) != 0) ||
+        (fread(t_header, sizeof(uint32_t), 6, a_file) != 6) ||
+        (t_header[0] != NN_BINARY_VERSION) ||
+        (t_header[1] != NN_BINARY_BYTE_ORDER))
+    {
+        return false;
+    }
+
+    const unsigned int N = t_header[4];
+    const unsigned int C = t_header[5];
+    if (static_cast<uint64_t>(t_header[2]) + t_header[3] > N)
+        return false;
+
+    // don't allocate for counts the file can't hold
+    long t_remaining = RemainingBytes(a_file);
+    if ((t_remaining < 0) ||
+        (N * NN_BINARY_NEURON_BYTES + C * NN_BINARY_CONNECTION_BYTES > static_cast<uint64_t>(t_remaining)))
+    {
+        return false;
+    }
+
+    std::vector<int32_t> t_type, t_aftype;
+    std::vector<double> t_a, t_b, t_timeconst, t_bias, t_split_y;
+    std::vector<uint32_t> t_source, t_target;
+    std::vector<double> t_weight, t_hebb_rate, t_hebb_pre_rate;
+    std::vector<uint8_t> t_recur;
+
+    bool t_ok = ReadArray(a_file, t_type, N) &&
+                ReadArray(a_file, t_aftype, N) &&
+                ReadArray(a_file, t_a, N) &&
+                ReadArray(a_file, t_b, N) &&
+                ReadArray(a_file, t_timeconst, N) &&
+                ReadArray(a_file, t_bias, N) &&
+                ReadArray(a_file, t_split_y, N) &&
+                ReadArray(a_file, t_source, C) &&
+                ReadArray(a_file, t_target, C) &&
+                ReadArray(a_file, t_weight, C) &&
+                ReadArray(a_file, t_recur, C) &&
+                ReadArray(a_file, t_hebb_rate, C) &&
+                ReadArray(a_file, t_hebb_pre_rate, C);
+    if (!t_ok)
+        return false;
+
+    for (unsigned int i = 0; i < N; i++)
+    {
+        if ((t_type[i] < NEAT::NONE) || (t_type[i] > NEAT::OUTPUT) ||
+            (t_aftype[i] < NEAT::SIGNED_SIGMOID) || (t_aftype[i] > NEAT::LINEAR))
+        {
+            return false;
+        }
+    }
+
+    for (unsigned int i = 0; i < C; i++)
+    {
+        if ((t_source[i] >= N) || (t_target[i] >= N))
+            return false;
+    }
+
+    Clear();
+    SetInputOutputDimentions(static_cast<unsigned short>(t_header[2]), static_cast<unsigned short>(t_header[3]));
+
+    m_neurons.resize(N);
+    _activated.assign(N, false);
+    _inActivation.assign(N, false);
+    for (unsigned int i = 0; i < N; i++)
+    {
+        Neuron& t_n = m_neurons[i];
+        t_n.id = i;
+        t_n.m_type = static_cast<NEAT::NeuronType>(t_type[i]);
+        t_n.m_activation_function_type = static_cast<NEAT::ActivationFunction>(t_aftype[i]);
+        t_n.m_a = t_a[i];
+        t_n.m_b = t_b[i];
+        t_n.m_timeconst = t_timeconst[i];
+        t_n.m_bias = t_bias[i];
+        t_n.m_split_y = t_split_y[i];
+    }
+
+    m_connections.reserve(C);
+    for (unsigned int i = 0; i < C; i++)
+    {
+        Connection t_c;
+        t_c.m_source_neuron_idx = t_source[i];
+        t_c.m_target_neuron_idx = t_target[i];
+        t_c.m_weight = t_weight[i];
+        t_c.m_signal = 0;
+        t_c.m_recur_flag = (t_recur[i] != 0);
+        t_c.m_hebb_rate = t_hebb_rate[i];
+        t_c.m_hebb_pre_rate = t_hebb_pre_rate[i];
+        m_connections.push_back(t_c);
+    }
+
+    Compile();
+    return true;
+}
+
 unsigned int NeuralNetwork::CalculateDepth()
 {
     if (is_depth_ready){
@@ -1025,6 +1361,7 @@ void NeuralNetwork::AddNeuron(const Neuron a_n) {
     m_neurons.push_back(a_n) ;
     this->_activated.push_back(false);
     this->_inActivation.push_back(false);
+    m_plan_ready = false;
 }
 
 void NeuralNetwork::RecursiveActivation(){
@@ -136,6 +136,87 @@ typedef boost::multi_index_container<
 > ConnectionSet;
 
 
+// A frozen, struct-of-arrays copy of a built network, used by the Activate*() methods.
+// Connections are stored as three parallel arrays, the non-input neurons are
+// reordered so that neurons with the same activation function are contiguous.
+// The plan holds no learning state - weights are copied in and must be recompiled
+// after anything changes them (see NeuralNetwork::Compile()).
+class ActivationPlan
+{
+public:
+    // connections, in the order of the ConnectionVector index
+    std::vector<unsigned int> m_source;
+    std::vector<unsigned int> m_target;
+    std::vector<double> m_weight;
+
+    // the non-input neurons, grouped by activation function
+    // m_neuron_idx[k] is the index in NeuralNetwork::m_neurons of the k-th entry
+    std::vector<unsigned int> m_neuron_idx;
+    std::vector<double> m_a, m_b, m_bias, m_timeconst;
+
+    // group g spans [m_group_start[g], m_group_start[g+1]) and uses m_group_type[g]
+    std::vector<ActivationFunction> m_group_type;
+    std::vector<unsigned int> m_group_start;
+
+    // The feed-forward schedule. Only built if the network has no loops.
+    // m_ff_neuron_idx holds the non-input neurons in topological order, the incoming
+    // links of the k-th one are [m_ff_start[k], m_ff_start[k+1]) in m_ff_source/m_ff_weight.
+    bool m_feed_forward;
+    std::vector<unsigned int> m_ff_neuron_idx;
+    std::vector<unsigned int> m_ff_slot; // position in the grouped arrays (m_a, m_b, ..)
+    std::vector<ActivationFunction> m_ff_type;
+    std::vector<unsigned int> m_ff_start;
+    std::vector<unsigned int> m_ff_source;
+    std::vector<double> m_ff_weight;
+
+    // working buffers
+    std::vector<double> m_activation; // indexed like m_neurons
+    std::vector<double> m_activesum;  // indexed like m_neurons
+    std::vector<double> m_x;          // net input, in group order
+    std::vector<double> m_y;          // output, in group order
+
+    // working buffers for batch activation, neuron-major with the samples contiguous
+    // i.e. the value of neuron i for sample s is at [i * num_samples + s]
+    std::vector<double> m_batch_activation;
+    std::vector<double> m_batch_activesum;
+    std::vector<double> m_batch_a;
+    std::vector<double> m_batch_b;
+
+    ActivationPlan(): m_feed_forward(false)
+    {
+    }
+
+    void Clear()
+    {
+        m_feed_forward = false;
+        m_ff_neuron_idx.clear();
+        m_ff_slot.clear();
+        m_ff_type.clear();
+        m_ff_start.clear();
+        m_ff_source.clear();
+        m_ff_weight.clear();
+        m_source.clear();
+        m_target.clear();
+        m_weight.clear();
+        m_neuron_idx.clear();
+        m_a.clear();
+        m_b.clear();
+        m_bias.clear();
+        m_timeconst.clear();
+        m_group_type.clear();
+        m_group_start.clear();
+        m_activation.clear();
+        m_activesum.clear();
+        m_x.clear();
+        m_y.clear();
+        m_batch_activation.clear();
+        m_batch_activesum.clear();
+        m_batch_a.clear();
+        m_batch_b.clear();
+    }
+};
+
+
 class NeuralNetwork
 {
 
@@ -153,6 +234,26 @@ class NeuralNetwork
     uint m_Depth;
     bool is_depth_ready;
 
+    // the compiled form of the network, rebuilt on demand when m_plan_ready is false
+    ActivationPlan m_plan;
+    bool m_plan_ready;
+
+    // use the vectorized approximations of exp() and sin() (see ActivationKernels.h)
+    bool m_fast_activation;
+
+    // builds the topological order of the plan (if there is one)
+    void CompileFeedForward();
+    // makes sure the plan matches the network (compiles it if needed)
+    void EnsurePlan();
+    // copies the neuron activations into the plan and sums up the weighted signals
+    void PlanPropagate();
+    // applies one activation function to n values, exact or approximated
+    void ApplyActivation(ActivationFunction a_type, const double* x, const double* a,
+                         const double* b, double* y, unsigned int n);
+    // runs the net inputs in m_plan.m_x through the activation functions
+    // and writes the results back to the neurons
+    void PlanActivate();
+
 public:
 
     unsigned short m_num_inputs, m_num_outputs;
@@ -173,6 +274,38 @@ public:
     void ActivateUseInternalBias(); // like Activate() but uses m_bias as well
     void ActivateLeaky(double step); // activates in leaky integrator mode
 
+    // Freezes the network into a flat activation plan used by the Activate*() methods.
+    // It is called automatically, but must be called again (or Invalidate()) if
+    // neuron parameters or weights are modified directly through m_neurons/m_connections.
+    void Compile();
+    void Invalidate() { m_plan_ready = false; }
+
+    // Propagates the inputs to the outputs in a single sweep, in topological order.
+    // Gives the same result as Flush(), Input() and Activate() repeated as many times
+    // as the network is deep, but only if there are no loops (see IsFeedForward()).
+    // Recurrent networks fall back to Activate() repeated CalculateDepth() times.
+    void ActivateFeedForward();
+    bool IsFeedForward();
+
+    // The same sweep for one input vector, reading a_Inputs[NumInputs()] and writing
+    // a_Outputs[NumOutputs()] without allocating. m_neurons is not touched.
+    // Only for networks without loops - check IsFeedForward() first.
+    void ActivateFeedForward(const double* a_Inputs, double* a_Outputs);
+
+    // Evaluates a whole batch of input vectors at once. a_Inputs is a row-major
+    // N x NumInputs() matrix, a_Outputs receives the N x NumOutputs() results.
+    // Each sample starts from a flushed network and is propagated until the outputs
+    // settle (like ActivateFeedForward()). The state of m_neurons is not touched.
+    void ActivateBatch(const std::vector<double>& a_Inputs, std::vector<double>& a_Outputs);
+    py::list ActivateBatch_python_list(py::list& a_Inputs);
+    bool IsCompiled() const { return m_plan_ready; }
+
+    // If set, Activate(), ActivateFast(), ActivateUseInternalBias(), ActivateLeaky() and
+    // ActivateBatch() use the fast approximated activation functions (error bounds in
+    // ActivationKernels.h). ActivateFeedForward() always uses the exact ones.
+    void SetFastActivation(bool a_fast) { m_fast_activation = a_fast; }
+    bool GetFastActivation() const { return m_fast_activation; }
+
     void RTRL_update_gradients();
     void RTRL_update_error(double a_target);
     void RTRL_update_weights();   // performs the backprop step
@@ -194,6 +327,7 @@ public:
         assert(a_c.m_source_neuron_idx < 100);
         assert(a_c.m_target_neuron_idx < 100);
         m_connections.push_back( a_c );
+        m_plan_ready = false;
     }
     Connection GetConnectionByIndex(unsigned int a_idx) const
     {
@@ -226,7 +360,12 @@ public:
         m_neurons.clear();
         m_connections.clear();
         m_total_weight_change.clear();
+        _activated.clear();
+        _inActivation.clear();
         SetInputOutputDimentions(0, 0);
+        m_plan.Clear();
+        m_plan_ready = false;
+        is_depth_ready = false;
     }
 
     // one-shot save/load
@@ -237,6 +376,17 @@ public:
     void Save(FILE* a_file);
     bool Load(std::ifstream& a_DataFile);
 
+    // Binary save/load. The format is versioned and keeps each neuron and connection
+    // field as one array, so loading is a few block reads instead of parsing text.
+    // The loaded network is compiled right away. Load returns false if the file is
+    // not a network in this version of the format, was written with another byte order
+    // or is truncated or corrupt (it must be seekable to check its size).
+    // Save returns false if the file can't be opened or written.
+    bool SaveBinary(const char* a_filename);
+    bool LoadBinary(const char* a_filename);
+    bool SaveBinary(FILE* a_file);
+    bool LoadBinary(FILE* a_file);
+
     unsigned int CalculateDepth();
     unsigned int NeuronDepth(unsigned int a_NeuronID, unsigned int a_Depth);
     Neuron & GetNeuronByID(uint ID);
@@ -70,6 +70,12 @@ void Parameters::Reset()
     // search quickly, yet less efficient, leave this to true.
     AllowClones = false;
 
+    // Number of threads for the parallel parts. 1 - run serially, 0 - one per core.
+    NumThreads = 1;
+
+    // One random stream for the whole reproduction
+    ParallelReproduction = false;
+
 
 
 
@@ -188,6 +194,15 @@ void Parameters::Reset()
     // Per how many evaluations to recompute the sparseness of the population
     NoveltySearch_Recompute_Sparseness_Each = 25;
 
+    // Compare with every behavior in the archive
+    NoveltySearch_Use_VPTree = false;
+
+    // The archive can grow without limit
+    NoveltySearch_Archive_Capacity = 0;
+
+    // When it is limited, keep a random sample
+    NoveltySearch_Archive_Eviction = RESERVOIR_EVICTION;
+
 
 
 
@@ -419,6 +434,18 @@ int Parameters::Load(std::ifstream& a_DataFile)
                 AllowClones = false;
         }
 
+        if (s == "NumThreads")
+            a_DataFile >> NumThreads;
+
+        if (s == "ParallelReproduction")
+        {
+            a_DataFile >> tf;
+            if (tf == "true" || tf == "1" || tf == "1.0")
+                ParallelReproduction = true;
+            else
+                ParallelReproduction = false;
+        }
+
         if (s == "YoungAgeTreshold")
             a_DataFile >> YoungAgeTreshold;
 
@@ -536,6 +563,25 @@ int Parameters::Load(std::ifstream& a_DataFile)
         if (s == "NoveltySearch_Recompute_Sparseness_Each")
             a_DataFile >> NoveltySearch_Recompute_Sparseness_Each;
 
+        if (s == "NoveltySearch_Use_VPTree")
+        {
+            a_DataFile >> tf;
+            if (tf == "true" || tf == "1" || tf == "1.0")
+                NoveltySearch_Use_VPTree = true;
+            else
+                NoveltySearch_Use_VPTree = false;
+        }
+
+        if (s == "NoveltySearch_Archive_Capacity")
+            a_DataFile >> NoveltySearch_Archive_Capacity;
+
+        if (s == "NoveltySearch_Archive_Eviction")
+        {
+            int t_eviction;
+            a_DataFile >> t_eviction;
+            NoveltySearch_Archive_Eviction = static_cast<ArchiveEviction>(t_eviction);
+        }
+
         if (s == "MutateAddNeuronProb")
             a_DataFile >> MutateAddNeuronProb;
 
@@ -764,6 +810,8 @@ void Parameters::Save(FILE* a_fstream)
     fprintf(a_fstream, "MaxSpecies %d\n", MaxSpecies);
     fprintf(a_fstream, "InnovationsForever %s\n", InnovationsForever==true?"true":"false");
     fprintf(a_fstream, "AllowClones %s\n", AllowClones==true?"true":"false");
+    fprintf(a_fstream, "NumThreads %u\n", NumThreads);
+    fprintf(a_fstream, "ParallelReproduction %s\n", ParallelReproduction==true?"true":"false");
     fprintf(a_fstream, "YoungAgeTreshold %d\n", YoungAgeTreshold);
     fprintf(a_fstream, "YoungAgeFitnessBoost %3.20f\n", YoungAgeFitnessBoost);
     fprintf(a_fstream, "SpeciesDropoffAge %d\n", SpeciesMaxStagnation);
@@ -793,6 +841,9 @@ void Parameters::Save(FILE* a_fstream)
     fprintf(a_fstream, "NoveltySearch_Quick_Archiving_Min_Evaluations %d\n", NoveltySearch_Quick_Archiving_Min_Evaluations);
     fprintf(a_fstream, "NoveltySearch_Pmin_raising_multiplier %3.20f\n", NoveltySearch_Pmin_raising_multiplier);
     fprintf(a_fstream, "NoveltySearch_Recompute_Sparseness_Each %d\n", NoveltySearch_Recompute_Sparseness_Each);
+    fprintf(a_fstream, "NoveltySearch_Use_VPTree %s\n", NoveltySearch_Use_VPTree==true?"true":"false");
+    fprintf(a_fstream, "NoveltySearch_Archive_Capacity %d\n", NoveltySearch_Archive_Capacity);
+    fprintf(a_fstream, "NoveltySearch_Archive_Eviction %d\n", NoveltySearch_Archive_Eviction);
     fprintf(a_fstream, "MutateAddNeuronProb %3.20f\n", MutateAddNeuronProb);
     fprintf(a_fstream, "SplitRecurrent %s\n", SplitRecurrent==true?"true":"false");
     fprintf(a_fstream, "SplitLoopedRecurrent %s\n", SplitLoopedRecurrent==true?"true":"false");
@@ -34,6 +34,14 @@
 namespace NEAT
 {
 
+// How a full novelty search archive makes room for a new behavior
+enum ArchiveEviction
+{
+    RESERVOIR_EVICTION,     // keeps a uniform random sample of all behaviors that qualified
+    LEAST_NOVEL_EVICTION,   // replaces the behavior that was the least sparse when it was added
+    MERGE_EVICTION          // averages the new behavior into its nearest one
+};
+
 
 //////////////////////////////////////////////
 // The NEAT Parameters class
@@ -75,6 +83,17 @@ public:
     // search quickly, yet less efficient, leave this to true.
     bool AllowClones;
 
+    // Number of threads used by the parallel parts of the algorithm (speciation, ..).
+    // 1 means everything runs in the calling thread, 0 means one thread per core.
+    // The results do not depend on it.
+    unsigned int NumThreads;
+
+    // Give every offspring of an epoch its own random stream, keyed by the generation,
+    // the species and the offspring's slot, so the parents are chosen, mated and mutated
+    // on NumThreads threads. The run is still reproducible from the seed, but the
+    // sequence differs from the one of the serial reproduction.
+    bool ParallelReproduction;
+
    ////////////////////////////////
     // GA Parameters
     ////////////////////////////////
@@ -184,6 +203,16 @@ public:
     // Per how many evaluations to recompute the sparseness
     unsigned int NoveltySearch_Recompute_Sparseness_Each;
 
+    // Search the archive for the nearest behaviors with a vantage-point tree instead of
+    // comparing with every behavior. Only exact if PhenotypeBehavior::Distance_To() is a metric.
+    bool NoveltySearch_Use_VPTree;
+
+    // Maximum number of behaviors in the archive, 0 for no limit
+    unsigned int NoveltySearch_Archive_Capacity;
+
+    // What to do with a new behavior when the archive is full
+    ArchiveEviction NoveltySearch_Archive_Eviction;
+
 
     ///////////////////////////////////
     // Mutation parameters
@@ -388,6 +417,118 @@ public:
 
     // resets the parameters to built-in defaults
     void Reset();
+
+    // Stores all parameters in a binary archive (see Population::SaveCheckpoint)
+    template<class Archive>
+    void serialize(Archive & ar, const unsigned int version)
+    {
+        ar & PopulationSize;
+        ar & DynamicCompatibility;
+        ar & MinSpecies;
+        ar & MaxSpecies;
+        ar & InnovationsForever;
+        ar & AllowClones;
+        ar & NumThreads;
+        ar & ParallelReproduction;
+        ar & YoungAgeTreshold;
+        ar & YoungAgeFitnessBoost;
+        ar & SpeciesMaxStagnation;
+        ar & StagnationDelta;
+        ar & OldAgeTreshold;
+        ar & OldAgePenalty;
+        ar & DetectCompetetiveCoevolutionStagnation;
+        ar & KillWorstSpeciesEach;
+        ar & KillWorstAge;
+        ar & SurvivalRate;
+        ar & CrossoverRate;
+        ar & OverallMutationRate;
+        ar & InterspeciesCrossoverRate;
+        ar & MultipointCrossoverRate;
+        ar & RouletteWheelSelection;
+        ar & PhasedSearching;
+        ar & DeltaCoding;
+        ar & SimplifyingPhaseMPCTreshold;
+        ar & SimplifyingPhaseStagnationTreshold;
+        ar & ComplexityFloorGenerations;
+        ar & NoveltySearch_K;
+        ar & NoveltySearch_P_min;
+        ar & NoveltySearch_Dynamic_Pmin;
+        ar & NoveltySearch_No_Archiving_Stagnation_Treshold;
+        ar & NoveltySearch_Pmin_lowering_multiplier;
+        ar & NoveltySearch_Pmin_min;
+        ar & NoveltySearch_Quick_Archiving_Min_Evaluations;
+        ar & NoveltySearch_Pmin_raising_multiplier;
+        ar & NoveltySearch_Recompute_Sparseness_Each;
+        ar & NoveltySearch_Use_VPTree;
+        ar & NoveltySearch_Archive_Capacity;
+        ar & NoveltySearch_Archive_Eviction;
+        ar & MutateAddNeuronProb;
+        ar & SplitRecurrent;
+        ar & SplitLoopedRecurrent;
+        ar & MutateAddLinkProb;
+        ar & MutateAddLinkFromBiasProb;
+        ar & MutateRemLinkProb;
+        ar & MutateRemSimpleNeuronProb;
+        ar & LinkTries;
+        ar & RecurrentProb;
+        ar & RecurrentLoopProb;
+        ar & MutateWeightsProb;
+        ar & MutateWeightsSevereProb;
+        ar & WeightMutationRate;
+        ar & WeightMutationMaxPower;
+        ar & WeightReplacementMaxPower;
+        ar & MaxWeight;
+        ar & MutateActivationAProb;
+        ar & MutateActivationBProb;
+        ar & ActivationAMutationMaxPower;
+        ar & ActivationBMutationMaxPower;
+        ar & TimeConstantMutationMaxPower;
+        ar & BiasMutationMaxPower;
+        ar & MinActivationA;
+        ar & MaxActivationA;
+        ar & MinActivationB;
+        ar & MaxActivationB;
+        ar & MutateNeuronActivationTypeProb;
+        ar & ActivationFunction_SignedSigmoid_Prob;
+        ar & ActivationFunction_UnsignedSigmoid_Prob;
+        ar & ActivationFunction_Tanh_Prob;
+        ar & ActivationFunction_TanhCubic_Prob;
+        ar & ActivationFunction_SignedStep_Prob;
+        ar & ActivationFunction_UnsignedStep_Prob;
+        ar & ActivationFunction_SignedGauss_Prob;
+        ar & ActivationFunction_UnsignedGauss_Prob;
+        ar & ActivationFunction_Abs_Prob;
+        ar & ActivationFunction_SignedSine_Prob;
+        ar & ActivationFunction_UnsignedSine_Prob;
+        ar & ActivationFunction_SignedSquare_Prob;
+        ar & ActivationFunction_UnsignedSquare_Prob;
+        ar & ActivationFunction_Linear_Prob;
+        ar & MutateNeuronTimeConstantsProb;
+        ar & MutateNeuronBiasesProb;
+        ar & MinNeuronTimeConstant;
+        ar & MaxNeuronTimeConstant;
+        ar & MinNeuronBias;
+        ar & MaxNeuronBias;
+        ar & DisjointCoeff;
+        ar & ExcessCoeff;
+        ar & ActivationADiffCoeff;
+        ar & ActivationBDiffCoeff;
+        ar & WeightDiffCoeff;
+        ar & TimeConstantDiffCoeff;
+        ar & BiasDiffCoeff;
+        ar & ActivationFunctionDiffCoeff;
+        ar & CompatTreshold;
+        ar & MinCompatTreshold;
+        ar & CompatTresholdModifier;
+        ar & CompatTreshChangeInterval_Generations;
+        ar & CompatTreshChangeInterval_Evaluations;
+        ar & InitialDepth;
+        ar & MaximumDepth;
+        ar & DivisionThreshold;
+        ar & VarianceThreshold;
+        ar & BandingThreshold;
+        ar & ESIterations;
+    }
 };
 
 } // namespace NEAT
@@ -59,6 +59,7 @@ public:
     }
 
     // Overload this method to calcluate distance between behaviors
+    // Population::RecomputeSparseness() calls it from several threads at once
     virtual double Distance_To(PhenotypeBehavior* a_Other)
     {
         //ASSERT(false);
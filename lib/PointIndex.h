@@ -0,0 +1,128 @@
+#ifndef POINTINDEX_H
+#define POINTINDEX_H
+
+#include <vector>
+#include <unordered_map>
+#include <string.h>
+#include <stdint.h>
+
+namespace NEAT
+{
+
+/*
+ * A set of 2D points (Point2D) looked up by their exact coordinates.
+ * The points are stored in one vector in the order they were inserted, a hash map
+ * gives the position of each one. Iterating goes in insertion order, so a snapshot
+ * is just the size() at that time: the points inserted after it are [begin() + snapshot, end()).
+ */
+template <typename T>
+class PointIndex
+{
+    typedef typename T::value_type value_type;
+
+    struct Key
+    {
+        value_type x, y;
+
+        Key(value_type _x, value_type _y):
+        x(_x + 0.0), y(_y + 0.0) // -0.0 becomes 0.0, they are the same point
+        {
+        }
+
+        bool operator==(const Key & other) const
+        {
+            return x == other.x && y == other.y;
+        }
+    };
+
+    struct KeyHash
+    {
+        size_t operator()(const Key & k) const
+        {
+            unsigned char bytes[2 * sizeof(value_type)];
+            memcpy(bytes, &k.x, sizeof(value_type));
+            memcpy(bytes + sizeof(value_type), &k.y, sizeof(value_type));
+            uint64_t h = 14695981039346656037ULL;
+            for (size_t i = 0; i < sizeof(bytes); i++)
+            {
+                h = (h ^ bytes[i]) * 1099511628211ULL;
+            }
+            return static_cast<size_t>(h);
+        }
+    };
+
+    std::vector<T> points;
+    std::unordered_map<Key, size_t, KeyHash> positions;
+
+public:
+    typedef typename std::vector<T>::iterator iterator;
+    typedef typename std::vector<T>::const_iterator const_iterator;
+
+    iterator begin(){
+        return points.begin();
+    }
+
+    iterator end(){
+        return points.end();
+    }
+
+    const_iterator begin() const{
+        return points.begin();
+    }
+
+    const_iterator end() const{
+        return points.end();
+    }
+
+    iterator find(const T & a_point){
+        auto it = positions.find(Key(a_point.X, a_point.Y));
+        if(it == positions.end()){
+            return points.end();
+        }
+        return points.begin() + it->second;
+    }
+
+    bool contains(const T & a_point) const{
+        return positions.count(Key(a_point.X, a_point.Y)) > 0;
+    }
+
+    // returns false if a point with the same coordinates is already there
+    bool insert(const T & a_point){
+        bool result = positions.emplace(Key(a_point.X, a_point.Y), points.size()).second;
+        if(result){
+            points.push_back(a_point);
+        }
+        return result;
+    }
+
+    // the data of the point with these coordinates, the point is inserted if it is not there
+    typename T::data_type & operator[](const T & a_point){
+        auto it = positions.emplace(Key(a_point.X, a_point.Y), points.size());
+        if(it.second){
+            points.push_back(a_point);
+        }
+        return points[it.first->second].data;
+    }
+
+    void clear(){
+        points.clear();
+        positions.clear();
+    }
+
+    void reserve(size_t a_size){
+        points.reserve(a_size);
+        positions.reserve(a_size);
+    }
+
+    size_t size() const{
+        return points.size();
+    }
+
+    bool checkSize() const{
+        return points.size() == positions.size();
+    }
+};
+
+}
+
+#endif // POINTINDEX_H
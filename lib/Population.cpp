@@ -31,6 +31,8 @@
 
 #include <algorithm>
 #include <fstream>
+#include <string.h>
+#include <limits.h>
 
 #include "Genome.h"
 #include "Species.h"
@@ -45,6 +47,10 @@
 namespace NEAT
 {
 
+// Checkpoint files start with this, followed by the format version
+static const char s_CheckpointMagic[4] = { 'M', 'N', 'P', 'C' };
+static const unsigned int s_CheckpointVersion = 1;
+
 // The constructor
 Population::Population(const Genome& a_Seed, const Parameters* a_Parameters, bool a_RandomizeWeights, double a_RandomizationRange)
 {
@@ -59,6 +65,8 @@ Population::Population(const Genome& a_Seed, const Parameters* a_Parameters, boo
     m_NextSpeciesID = 1;
     m_GensSinceBestFitnessLastChanged = 0;
     m_GensSinceMPCLastChanged = 0;
+    m_NumArchiveCandidates = 0;
+    m_NumArchiveEvictions = 0;
 
     // Spawn the population
     for(unsigned int i=0; i<m_Parameters.PopulationSize; i++)
@@ -111,12 +119,24 @@ Population::Population(const char *a_FileName)
     m_NextSpeciesID = 1;
     m_GensSinceBestFitnessLastChanged = 0;
     m_GensSinceMPCLastChanged = 0;
+    m_NumArchiveCandidates = 0;
+    m_NumArchiveEvictions = 0;
 
-    std::ifstream t_DataFile(a_FileName);
+    std::ifstream t_DataFile(a_FileName, std::ios::binary);
     if (!t_DataFile.is_open())
         throw std::exception();
     std::string t_str;
 
+    // A checkpoint has the whole state, nothing else to do
+    char t_magic[sizeof(s_CheckpointMagic)];
+    if (t_DataFile.read(t_magic, sizeof(t_magic)) && (memcmp(t_magic, s_CheckpointMagic, sizeof(t_magic)) == 0))
+    {
+        LoadCheckpoint(t_DataFile);
+        return;
+    }
+    t_DataFile.clear();
+    t_DataFile.seekg(0);
+
     // Load the parameters
     m_Parameters.Load(t_DataFile);
 
@@ -187,6 +207,93 @@ void Population::Save(const char* a_FileName)
 }
 
 
+void Population::SaveCheckpoint(const char* a_FileName)
+{
+    std::ofstream t_DataFile(a_FileName, std::ios::binary);
+    if (!t_DataFile.is_open())
+        throw std::exception();
+
+    t_DataFile.write(s_CheckpointMagic, sizeof(s_CheckpointMagic));
+    t_DataFile.write(reinterpret_cast<const char*>(&s_CheckpointVersion), sizeof(s_CheckpointVersion));
+
+    // The archive writes straight to the file, one genome after another
+    {
+        boost::archive::binary_oarchive t_ar(t_DataFile);
+
+        t_ar << m_Parameters;
+        t_ar << m_RNG;
+        t_ar << m_InnovationDatabase;
+
+        t_ar << m_NextGenomeID;
+        t_ar << m_NextSpeciesID;
+        t_ar << m_Generation;
+        t_ar << m_NumEvaluations;
+
+        t_ar << m_SearchMode;
+        t_ar << m_CurrentMPC;
+        t_ar << m_OldMPC;
+        t_ar << m_BaseMPC;
+
+        t_ar << m_BestFitnessEver;
+        t_ar << m_BestGenome;
+        t_ar << m_BestGenomeEver;
+        t_ar << m_GensSinceBestFitnessLastChanged;
+        t_ar << m_GensSinceMPCLastChanged;
+
+        t_ar << m_GensSinceLastArchiving;
+        t_ar << m_QuickAddCounter;
+
+        t_ar << m_Species;
+    }
+
+    if (!t_DataFile)
+        throw std::exception();
+}
+
+
+void Population::LoadCheckpoint(std::ifstream& a_DataFile)
+{
+    unsigned int t_version = 0;
+    a_DataFile.read(reinterpret_cast<char*>(&t_version), sizeof(t_version));
+    if (!a_DataFile || (t_version != s_CheckpointVersion))
+        throw std::exception();
+
+    boost::archive::binary_iarchive t_ar(a_DataFile);
+
+    t_ar >> m_Parameters;
+    t_ar >> m_RNG;
+    t_ar >> m_InnovationDatabase;
+
+    t_ar >> m_NextGenomeID;
+    t_ar >> m_NextSpeciesID;
+    t_ar >> m_Generation;
+    t_ar >> m_NumEvaluations;
+
+    t_ar >> m_SearchMode;
+    t_ar >> m_CurrentMPC;
+    t_ar >> m_OldMPC;
+    t_ar >> m_BaseMPC;
+
+    t_ar >> m_BestFitnessEver;
+    t_ar >> m_BestGenome;
+    t_ar >> m_BestGenomeEver;
+    t_ar >> m_GensSinceBestFitnessLastChanged;
+    t_ar >> m_GensSinceMPCLastChanged;
+
+    t_ar >> m_GensSinceLastArchiving;
+    t_ar >> m_QuickAddCounter;
+
+    t_ar >> m_Species;
+
+    // The species are not formed again, m_Genomes only has to tell the population size
+    m_Genomes.clear();
+    for(unsigned int i=0; i<m_Species.size(); i++)
+    {
+        m_Genomes.insert(m_Genomes.end(), m_Species[i].m_Individuals.begin(), m_Species[i].m_Individuals.end());
+    }
+}
+
+
 // Calculates the current mean population complexity
 void Population::CalculateMPC()
 {
@@ -201,6 +308,11 @@ void Population::CalculateMPC()
 }
 
 
+ThreadPool& Population::GetThreadPool()
+{
+    return EnsureThreadPool(m_ThreadPool, m_Parameters.NumThreads);
+}
+
 // Separates the population into species
 // also adjusts the compatibility treshold if this feature is enabled
 void Population::Speciate()
@@ -209,30 +321,52 @@ void Population::Speciate()
     // at least 1 genome must be present
     ASSERT(m_Genomes.size() > 0);
 
-    bool t_added = false;
-
     // NOTE: we are comparing the new generation's genomes to the representatives from the previous generation!
     // Any new species that is created is assigned a representative from the new generation.
+
+    // First find the first compatible species among the existing ones for every genome.
+    // This is where the time goes and the genomes don't depend on each other, so it runs in parallel.
+    // -1 means that none of the existing species fits.
+    const unsigned int t_num_existing = static_cast<unsigned int>(m_Species.size());
+    std::vector<int> t_first_compatible(m_Genomes.size(), -1);
+
+    GetThreadPool().ParallelFor(static_cast<unsigned int>(m_Genomes.size()), [&](unsigned int i)
+    {
+        for(unsigned int j=0; j<t_num_existing; j++)
+        {
+            if (m_Genomes[i].IsCompatibleWith( m_Species[j].GetRepresentative(), m_Parameters ))
+            {
+                t_first_compatible[i] = j;
+                break;
+            }
+        }
+    });
+
+    // Now assign the genomes in order. The existing species come first in the list,
+    // so checking the species created in this pass only when none of them fits
+    // gives the same result as checking each genome against all species one by one.
     for(unsigned int i=0; i<m_Genomes.size(); i++)
     {
-        t_added = false;
+        int t_species = t_first_compatible[i];
 
-        // iterate through each species and check if compatible. If compatible, then add to the species.
-        // if not compatible, create a new species.
-        for(unsigned int j=0; j<m_Species.size(); j++)
+        if (t_species == -1)
         {
-            Genome tmp = m_Species[j].GetRepresentative();
-            if (m_Genomes[i].IsCompatibleWith( tmp, m_Parameters ))
+            for(unsigned int j=t_num_existing; j<m_Species.size(); j++)
             {
-                // Compatible, add to species
-                m_Species[j].AddIndividual( m_Genomes[i] );
-                t_added = true;
-
-                break;
+                if (m_Genomes[i].IsCompatibleWith( m_Species[j].GetRepresentative(), m_Parameters ))
+                {
+                    t_species = j;
+                    break;
+                }
             }
         }
 
-        if (!t_added)
+        if (t_species != -1)
+        {
+            // Compatible, add to species
+            m_Species[t_species].AddIndividual( m_Genomes[i] );
+        }
+        else
         {
             // didn't find compatible species, create new species
             m_Species.push_back( Species(m_Genomes[i], m_NextSpeciesID));
@@ -663,9 +797,16 @@ void Population::Epoch()
     for(unsigned int i=0; i<m_TempSpecies.size(); i++)
         m_TempSpecies[i].Clear();
 
-    for(unsigned int i=0; i<m_Species.size(); i++)
+    if (m_Parameters.ParallelReproduction)
+    {
+        ReproduceInParallel();
+    }
+    else
     {
-        m_Species[i].Reproduce(*this, m_Parameters, m_RNG);
+        for(unsigned int i=0; i<m_Species.size(); i++)
+        {
+            m_Species[i].Reproduce(*this, m_Parameters, m_RNG);
+        }
     }
 
     m_Species = m_TempSpecies;
@@ -731,6 +872,41 @@ void Population::Epoch()
 }
 
 
+// Reproduces all species into m_TempSpecies with one random stream per offspring.
+// The babies are drafted on the thread pool, then finished serially in the order
+// of the species and slots, so the IDs and innovation numbers are assigned the same
+// way for any number of threads.
+void Population::ReproduceInParallel()
+{
+    // the streams of this epoch are keyed by a seed from the main generator,
+    // so the run is still reproducible from its seed
+    unsigned int t_seed = static_cast<unsigned int>(m_RNG.RandInt(0, INT_MAX));
+
+    // (species, slot) of every offspring
+    std::vector< std::pair<unsigned int, unsigned int> > t_slots;
+    for(unsigned int i=0; i<m_Species.size(); i++)
+    {
+        int t_offspring_count = Rounded(m_Species[i].GetOffspringRqd());
+        for(int j=0; j<t_offspring_count; j++)
+        {
+            t_slots.push_back(std::make_pair(i, static_cast<unsigned int>(j)));
+        }
+    }
+
+    std::vector<Offspring> t_offspring(t_slots.size());
+    GetThreadPool().ParallelFor(static_cast<unsigned int>(t_slots.size()), [&](unsigned int i)
+    {
+        m_Species[t_slots[i].first].DraftOffspring(t_slots[i].second, t_seed, m_Generation,
+                                                   *this, m_Parameters, t_offspring[i]);
+    });
+
+    for(unsigned int i=0; i<t_slots.size(); i++)
+    {
+        m_Species[t_slots[i].first].FinishOffspring(*this, m_Parameters, t_offspring[i]);
+    }
+}
+
+
 
 
 
@@ -864,12 +1040,12 @@ void Population::ReassignSpecies(unsigned int a_genome_idx)
     else
     {
         // try to find a compatible species
-        Genome t_to_compare = t_cur_species->GetRepresentative();
+        const Genome* t_to_compare = &t_cur_species->GetRepresentative();
 
         t_found = false;
         while((t_cur_species != m_Species.end()) && (!t_found))
         {
-            if (t_genome.IsCompatibleWith( t_to_compare, m_Parameters ))
+            if (t_genome.IsCompatibleWith( *t_to_compare, m_Parameters ))
             {
                 // found a compatible species
                 t_cur_species->AddIndividual(t_genome);
@@ -881,7 +1057,7 @@ void Population::ReassignSpecies(unsigned int a_genome_idx)
                 t_cur_species++;
                 if (t_cur_species != m_Species.end())
                 {
-                    t_to_compare = t_cur_species->GetRepresentative();
+                    t_to_compare = &t_cur_species->GetRepresentative();
                 }
             }
         }
@@ -1022,12 +1198,12 @@ Genome* Population::Tick(Genome& a_deleted_genome)
     else
     {
         // try to find a compatible species
-        Genome t_to_compare = t_cur_species->GetRepresentative();
+        const Genome* t_to_compare = &t_cur_species->GetRepresentative();
 
         t_found = false;
         while((t_cur_species != m_Species.end()) && (!t_found))
         {
-            if (t_baby.IsCompatibleWith( t_to_compare, m_Parameters))
+            if (t_baby.IsCompatibleWith( *t_to_compare, m_Parameters))
             {
                 // found a compatible species
                 t_cur_species->AddIndividual(t_baby);
@@ -1040,7 +1216,7 @@ Genome* Population::Tick(Genome& a_deleted_genome)
                 t_cur_species++;
                 if (t_cur_species != m_Species.end())
                 {
-                    t_to_compare = t_cur_species->GetRepresentative();
+                    t_to_compare = &t_cur_species->GetRepresentative();
                 }
             }
         }
@@ -1124,8 +1300,24 @@ void Population::InitPhenotypeBehaviorData(std::vector< PhenotypeBehavior >* a_p
 {
     // Now make each genome point to its behavior
     a_population->resize(NumGenomes());
+    m_BehaviorPopulation = a_population;
     m_BehaviorArchive = a_archive;
     m_BehaviorArchive->clear();
+    m_BehaviorStore.reset();
+    m_ArchiveSparseness.clear();
+    m_ArchiveWeights.clear();
+    m_NumArchiveCandidates = 0;
+    m_NumArchiveEvictions = 0;
+
+    if (m_Parameters.NoveltySearch_Use_VPTree)
+    {
+        // the population has behaviors of the user's type, the archive only copies
+        m_BehaviorIndex = std::make_shared<VPTreeBehaviorIndex>(PrototypeBehaviorDistance(&((*a_population)[0])));
+    }
+    else
+    {
+        m_BehaviorIndex = std::make_shared<BruteForceBehaviorIndex>();
+    }
 
     ASSERT(a_population->size() == NumGenomes());
     int counter = 0;
@@ -1144,32 +1336,368 @@ double Population::ComputeSparseness(Genome& genome)
 {
     // this will hold the distances from our new behavior
     std::vector< double > t_distances_list;
-    t_distances_list.clear();
+
+    UpdateBehaviorSearch();
 
     // first add all distances from the population
     for(unsigned int i=0; i<m_Species.size(); i++)
     {
         for(unsigned int j=0; j<m_Species[i].m_Individuals.size(); j++)
         {
-            double distance = genome.m_PhenotypeBehavior->Distance_To( m_Species[i].m_Individuals[j].m_PhenotypeBehavior );
-            t_distances_list.push_back( distance );
+            t_distances_list.push_back( BehaviorDistanceBetween(genome, m_Species[i].m_Individuals[j]) );
+        }
+    }
+
+    // then add the distances to the nearest ones from the archive
+    AddNearestArchiveDistances(genome, t_distances_list);
+
+    return Sparseness(t_distances_list);
+}
+
+
+// Recomputes the sparseness of every individual and sets it as its fitness.
+// The distance between two individuals is computed once and goes to the K+1 nearest of both,
+// then each individual is compared to the archive.
+// The individuals are cut into tiles. In each round every tile is paired with another one
+// (round-robin), so the pairs of a round run in parallel without sharing an individual.
+void Population::RecomputeSparseness()
+{
+    std::vector<Genome*> t_genomes;
+    for(unsigned int i=0; i<m_Species.size(); i++)
+    {
+        for(unsigned int j=0; j<m_Species[i].m_Individuals.size(); j++)
+        {
+            t_genomes.push_back(&m_Species[i].m_Individuals[j]);
+        }
+    }
+    unsigned int t_size = static_cast<unsigned int>(t_genomes.size());
+    if (t_size == 0)
+        return;
+
+    UpdateBehaviorSearch();
+
+    // the nearest individuals to each one as (distance, individual), max-heaps
+    unsigned int t_num_nearest = m_Parameters.NoveltySearch_K + 1;
+    std::vector< std::vector< std::pair<double, int> > > t_nearest(t_size);
+
+    // a few tiles per thread, an even number of them (the last ones may be empty)
+    unsigned int t_num_tiles = std::min(t_size, 4 * GetThreadPool().NumThreads());
+    t_num_tiles += t_num_tiles % 2;
+    unsigned int t_tile_size = (t_size + t_num_tiles - 1) / t_num_tiles;
+
+    auto t_compare_tiles = [&](unsigned int a_First, unsigned int a_Second)
+    {
+        unsigned int t_first_end = std::min((a_First + 1) * t_tile_size, t_size);
+        unsigned int t_second_end = std::min((a_Second + 1) * t_tile_size, t_size);
+        for(unsigned int i=a_First * t_tile_size; i<t_first_end; i++)
+        {
+            // a tile with itself has each pair once, and the distance to itself
+            for(unsigned int j=((a_First == a_Second) ? i : a_Second * t_tile_size); j<t_second_end; j++)
+            {
+                double t_distance = BehaviorDistanceBetween(*t_genomes[i], *t_genomes[j]);
+                ConsiderNearest(t_nearest[i], t_distance, j, t_num_nearest);
+                if (j != i)
+                    ConsiderNearest(t_nearest[j], t_distance, i, t_num_nearest);
+            }
         }
+    };
+
+    GetThreadPool().ParallelFor(t_num_tiles, [&](unsigned int a)
+    {
+        t_compare_tiles(a, a);
+    });
+
+    // the circle method: tile 0 stays, the others rotate and each pair meets once
+    unsigned int t_num_rotating = t_num_tiles - 1;
+    for(unsigned int t_round=0; t_round<t_num_rotating; t_round++)
+    {
+        GetThreadPool().ParallelFor(t_num_tiles / 2, [&](unsigned int p)
+        {
+            if (p == 0)
+                t_compare_tiles(0, 1 + t_round % t_num_rotating);
+            else
+                t_compare_tiles(1 + (t_round + p) % t_num_rotating, 1 + (t_round + t_num_rotating - p) % t_num_rotating);
+        });
     }
 
-    // then add all distances from the archive
+    GetThreadPool().ParallelFor(t_size, [&](unsigned int i)
+    {
+        std::vector<double> t_distances_list;
+        for(unsigned int j=0; j<t_nearest[i].size(); j++)
+        {
+            t_distances_list.push_back(t_nearest[i][j].first);
+        }
+        AddNearestArchiveDistances(*t_genomes[i], t_distances_list);
+        t_genomes[i]->SetFitness(Sparseness(t_distances_list));
+    });
+}
+
+
+// Uses the behavior store if there is one
+void Population::InitBehaviorStore(unsigned int a_Dimension, BehaviorDistance a_Distance)
+{
+    ASSERT(m_BehaviorPopulation != NULL);
+
+    // the population slots first, then the archive
+    m_BehaviorStore = std::make_shared<BehaviorStore>(a_Dimension, a_Distance);
+    m_BehaviorStore->Resize(static_cast<unsigned int>(m_BehaviorPopulation->size()));
     for(unsigned int i=0; i<m_BehaviorArchive->size(); i++)
     {
-        t_distances_list.push_back( genome.m_PhenotypeBehavior->Distance_To( &((*m_BehaviorArchive)[i])));
+        m_BehaviorStore->Resize(m_BehaviorStore->Size() + 1);
+        m_BehaviorStore->SetRow(m_BehaviorStore->Size() - 1, (*m_BehaviorArchive)[i]);
     }
+}
+
+
+// The row of the behavior store with the behavior of a genome
+unsigned int Population::BehaviorRow(const Genome& a_Genome) const
+{
+    ASSERT((a_Genome.m_PhenotypeBehavior >= &((*m_BehaviorPopulation)[0])) &&
+           (a_Genome.m_PhenotypeBehavior < &((*m_BehaviorPopulation)[0]) + m_BehaviorPopulation->size()));
+    return static_cast<unsigned int>(a_Genome.m_PhenotypeBehavior - &((*m_BehaviorPopulation)[0]));
+}
 
-    // sort the list, smaller first
-    std::sort( t_distances_list.begin(), t_distances_list.end() );
+
+// Gets the archive search ready for the queries: copies the population's behaviors
+// to the behavior store, or indexes the new archive entries
+void Population::UpdateBehaviorSearch()
+{
+    if (m_BehaviorStore)
+    {
+        for(unsigned int i=0; i<m_Species.size(); i++)
+        {
+            for(unsigned int j=0; j<m_Species[i].m_Individuals.size(); j++)
+            {
+                const Genome& t_genome = m_Species[i].m_Individuals[j];
+                m_BehaviorStore->SetRow(BehaviorRow(t_genome), *t_genome.m_PhenotypeBehavior);
+            }
+        }
+    }
+    else
+    {
+        m_BehaviorIndex->Update(*m_BehaviorArchive);
+    }
+}
+
+
+double Population::BehaviorDistanceBetween(const Genome& a_Genome, const Genome& a_Other) const
+{
+    if (m_BehaviorStore)
+    {
+        return m_BehaviorStore->Distance(BehaviorRow(a_Genome), BehaviorRow(a_Other));
+    }
+    else
+    {
+        return a_Genome.m_PhenotypeBehavior->Distance_To(a_Other.m_PhenotypeBehavior);
+    }
+}
+
+
+// The other archive behaviors can't be among the K+1 nearest
+void Population::AddNearestArchiveDistances(const Genome& a_Genome, std::vector<double>& a_Distances) const
+{
+    unsigned int t_num_nearest = m_Parameters.NoveltySearch_K + 1;
+    std::vector< std::pair<double, int> > t_nearest;
+    if (m_BehaviorStore)
+    {
+        m_BehaviorStore->FindNearest(m_BehaviorStore->Row(BehaviorRow(a_Genome)), static_cast<unsigned int>(m_BehaviorPopulation->size()),
+                                     m_BehaviorStore->Size(), t_num_nearest, t_nearest);
+    }
+    else
+    {
+        m_BehaviorIndex->FindNearest(a_Genome.m_PhenotypeBehavior, t_num_nearest, t_nearest);
+    }
+
+    for(unsigned int i=0; i<t_nearest.size(); i++)
+    {
+        a_Distances.push_back(t_nearest[i].first);
+    }
+}
+
+
+// Adds the behavior of a genome to the archive. If the archive is full,
+// m_Parameters.NoveltySearch_Archive_Eviction decides what happens.
+void Population::AddToArchive(Genome& a_Genome, double a_Sparseness)
+{
+    unsigned int t_size = GetArchiveSize();
+    unsigned int t_capacity = m_Parameters.NoveltySearch_Archive_Capacity;
+    m_NumArchiveCandidates++;
+
+    // entries added before these were kept count as added with no sparseness
+    m_ArchiveSparseness.resize(t_size, 0.0);
+    m_ArchiveWeights.resize(t_size, 1);
+
+    if ((t_capacity == 0) || (t_size < t_capacity))
+    {
+        if (m_BehaviorStore)
+        {
+            m_BehaviorStore->CopyRow(BehaviorRow(a_Genome));
+        }
+        else
+        {
+            m_BehaviorArchive->push_back( *(a_Genome.m_PhenotypeBehavior) );
+        }
+        m_ArchiveSparseness.push_back(a_Sparseness);
+        m_ArchiveWeights.push_back(1);
+        return;
+    }
+
+    switch (m_Parameters.NoveltySearch_Archive_Eviction)
+    {
+    case LEAST_NOVEL_EVICTION:
+    {
+        unsigned int t_least = static_cast<unsigned int>(std::min_element(m_ArchiveSparseness.begin(), m_ArchiveSparseness.end()) - m_ArchiveSparseness.begin());
+        if (a_Sparseness > m_ArchiveSparseness[t_least])
+        {
+            ReplaceArchiveEntry(t_least, a_Genome, a_Sparseness);
+            m_NumArchiveEvictions++;
+        }
+        break;
+    }
+
+    case MERGE_EVICTION:
+    {
+        std::vector< std::pair<double, int> > t_nearest;
+        UpdateBehaviorSearch();
+        if (m_BehaviorStore)
+        {
+            unsigned int t_first = static_cast<unsigned int>(m_BehaviorPopulation->size());
+            m_BehaviorStore->FindNearest(m_BehaviorStore->Row(BehaviorRow(a_Genome)), t_first, m_BehaviorStore->Size(), 1, t_nearest);
+            t_nearest[0].second -= t_first;
+        }
+        else
+        {
+            m_BehaviorIndex->FindNearest(a_Genome.m_PhenotypeBehavior, 1, t_nearest);
+        }
+        MergeIntoArchiveEntry(t_nearest[0].second, a_Genome, a_Sparseness);
+        m_NumArchiveEvictions++;
+        break;
+    }
+
+    case RESERVOIR_EVICTION:
+    default:
+    {
+        // each behavior that qualified stays with the same probability
+        unsigned int t_slot = static_cast<unsigned int>(m_RNG.RandInt(0, static_cast<int>(m_NumArchiveCandidates) - 1));
+        if (t_slot < t_size)
+        {
+            ReplaceArchiveEntry(t_slot, a_Genome, a_Sparseness);
+            m_NumArchiveEvictions++;
+        }
+        break;
+    }
+    }
+}
+
+
+// Puts the behavior of a genome in the place of an archive entry
+void Population::ReplaceArchiveEntry(unsigned int a_Idx, Genome& a_Genome, double a_Sparseness)
+{
+    if (m_BehaviorStore)
+    {
+        const double* t_row = m_BehaviorStore->Row(BehaviorRow(a_Genome));
+        std::copy(t_row, t_row + m_BehaviorStore->Dimension(), m_BehaviorStore->Row(static_cast<unsigned int>(m_BehaviorPopulation->size()) + a_Idx));
+    }
+    else
+    {
+        m_BehaviorIndex->Remove(a_Idx);
+        (*m_BehaviorArchive)[a_Idx] = *(a_Genome.m_PhenotypeBehavior);
+    }
+
+    m_ArchiveSparseness[a_Idx] = a_Sparseness;
+    m_ArchiveWeights[a_Idx] = 1;
+}
+
+
+// Makes an archive entry the average of the behaviors merged into it
+// and the behavior of a genome. Their m_Data must have the same shape.
+void Population::MergeIntoArchiveEntry(unsigned int a_Idx, Genome& a_Genome, double a_Sparseness)
+{
+    double t_weight = m_ArchiveWeights[a_Idx];
+
+    if (m_BehaviorStore)
+    {
+        const double* t_row = m_BehaviorStore->Row(BehaviorRow(a_Genome));
+        double* t_entry = m_BehaviorStore->Row(static_cast<unsigned int>(m_BehaviorPopulation->size()) + a_Idx);
+        for(unsigned int i=0; i<m_BehaviorStore->Dimension(); i++)
+        {
+            t_entry[i] = (t_entry[i] * t_weight + t_row[i]) / (t_weight + 1);
+        }
+    }
+    else
+    {
+        m_BehaviorIndex->Remove(a_Idx);
+
+        std::vector< std::vector<double> >& t_entry = (*m_BehaviorArchive)[a_Idx].m_Data;
+        const std::vector< std::vector<double> >& t_data = a_Genome.m_PhenotypeBehavior->m_Data;
+        ASSERT(t_entry.size() == t_data.size());
+        for(unsigned int i=0; i<t_entry.size(); i++)
+        {
+            ASSERT(t_entry[i].size() == t_data[i].size());
+            for(unsigned int j=0; j<t_entry[i].size(); j++)
+            {
+                t_entry[i][j] = (t_entry[i][j] * t_weight + t_data[i][j]) / (t_weight + 1);
+            }
+        }
+    }
+
+    m_ArchiveSparseness[a_Idx] = std::max(m_ArchiveSparseness[a_Idx], a_Sparseness);
+    m_ArchiveWeights[a_Idx]++;
+}
+
+
+unsigned int Population::GetArchiveSize() const
+{
+    if (m_BehaviorStore)
+    {
+        return m_BehaviorStore->Size() - static_cast<unsigned int>(m_BehaviorPopulation->size());
+    }
+    else
+    {
+        return static_cast<unsigned int>(m_BehaviorArchive->size());
+    }
+}
+
+
+size_t Population::GetArchiveMemoryUsage() const
+{
+    size_t t_bytes = m_ArchiveSparseness.capacity() * sizeof(double) + m_ArchiveWeights.capacity() * sizeof(unsigned int);
+
+    if (m_BehaviorStore)
+    {
+        t_bytes += static_cast<size_t>(GetArchiveSize()) * m_BehaviorStore->Dimension() * sizeof(double);
+    }
+    else
+    {
+        t_bytes += m_BehaviorArchive->capacity() * sizeof(PhenotypeBehavior);
+        for(unsigned int i=0; i<m_BehaviorArchive->size(); i++)
+        {
+            const std::vector< std::vector<double> >& t_data = (*m_BehaviorArchive)[i].m_Data;
+            t_bytes += t_data.capacity() * sizeof(std::vector<double>);
+            for(unsigned int j=0; j<t_data.size(); j++)
+            {
+                t_bytes += t_data[j].capacity() * sizeof(double);
+            }
+        }
+    }
+
+    return t_bytes;
+}
+
+
+// Returns the sparseness given the distances to the population and the nearest archive behaviors
+double Population::Sparseness(std::vector<double>& a_Distances) const
+{
+    // only the K+1 smallest are needed, smaller first
+    unsigned int t_num_nearest = std::min(m_Parameters.NoveltySearch_K + 1, static_cast<unsigned int>(a_Distances.size()));
+    std::partial_sort( a_Distances.begin(), a_Distances.begin() + t_num_nearest, a_Distances.end() );
 
     // now compute the sparseness
+    // the first one is the distance to itself
     double t_sparseness = 0;
-    for(unsigned int i=1; i< (m_Parameters.NoveltySearch_K+1); i++)
+    for(unsigned int i=1; i<t_num_nearest; i++)
     {
-        t_sparseness += t_distances_list[i];
+        t_sparseness += a_Distances[i];
     }
     t_sparseness /= m_Parameters.NoveltySearch_K;
 
@@ -1189,11 +1717,7 @@ bool Population::NoveltySearchTick(Genome& a_SuccessfulGenome)
     // This will introduce the constant pressure to do something new
     if ((m_NumEvaluations % m_Parameters.NoveltySearch_Recompute_Sparseness_Each)==0)
     {
-        for(unsigned int i=0; i<m_Species.size(); i++)
-            for(unsigned int j=0; j<m_Species[i].m_Individuals.size(); j++)
-            {
-                m_Species[i].m_Individuals[j].SetFitness(ComputeSparseness(m_Species[i].m_Individuals[j]));
-            }
+        RecomputeSparseness();
     }
 
     // OK now get the new baby
@@ -1240,7 +1764,7 @@ bool Population::NoveltySearchTick(Genome& a_SuccessfulGenome)
 
         if (!present)
         {
-            m_BehaviorArchive->push_back( *(t_new_baby->m_PhenotypeBehavior) );
+            AddToArchive(*t_new_baby, t_sparseness);
             m_GensSinceLastArchiving = 0;
             m_QuickAddCounter++;
         }
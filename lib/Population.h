@@ -31,6 +31,7 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include <vector>
+#include <memory>
 
 #include "Innovation.h"
 #include "Genome.h"
@@ -39,6 +40,9 @@
 #include "Species.h"
 #include "Parameters.h"
 #include "Random.h"
+#include "ThreadPool.h"
+#include "BehaviorIndex.h"
+#include "BehaviorStore.h"
 
 namespace NEAT
 {
@@ -123,6 +127,27 @@ private:
     // The initial list of genomes
     std::vector<Genome> m_Genomes;
 
+    // Loads a checkpoint written by SaveCheckpoint() from an opened file,
+    // positioned after the magic and version
+    void LoadCheckpoint(std::ifstream& a_DataFile);
+
+    // The reproduction of Epoch() when m_Parameters.ParallelReproduction is set
+    void ReproduceInParallel();
+
+    // Novelty search helpers, they use m_BehaviorStore if it is set
+    unsigned int BehaviorRow(const Genome& a_Genome) const;
+    void UpdateBehaviorSearch();
+    double BehaviorDistanceBetween(const Genome& a_Genome, const Genome& a_Other) const;
+    void AddNearestArchiveDistances(const Genome& a_Genome, std::vector<double>& a_Distances) const;
+    double Sparseness(std::vector<double>& a_Distances) const;
+    void AddToArchive(Genome& a_Genome, double a_Sparseness);
+    void ReplaceArchiveEntry(unsigned int a_Idx, Genome& a_Genome, double a_Sparseness);
+    void MergeIntoArchiveEntry(unsigned int a_Idx, Genome& a_Genome, double a_Sparseness);
+
+    // Runs the parallel parts, created on demand with m_Parameters.NumThreads threads.
+    // Copies of the population share it (ParallelFor calls are serialized).
+    std::shared_ptr<ThreadPool> m_ThreadPool;
+
 public:
 
     // Random number generator
@@ -148,7 +173,8 @@ public:
     Population(const Genome& a_G, const Parameters *a_Parameters, bool a_RandomizeWeights, double a_RandomRange);
 
 
-    // Loads a population from a file.
+    // Loads a population from a file, either saved by Save() or a checkpoint
+    // saved by SaveCheckpoint().
     Population(const char* a_FileName);
 
     ////////////////////////////
@@ -205,6 +231,9 @@ public:
 
     InnovationDatabase& AccessInnovationDatabase() { return m_InnovationDatabase; }
 
+    // The thread pool for the parallel parts, (re)created if NumThreads changed
+    ThreadPool& GetThreadPool();
+
     // Sorts each species's genomes by fitness
     void Sort();
 
@@ -214,6 +243,15 @@ public:
     // Saves the whole population to a file
     void Save(const char* a_FileName);
 
+    // Saves the whole state of the evolution to a binary file: the parameters, the RNG state,
+    // the innovation database, the species with their members, ages and stagnation counters,
+    // and the best genomes. Loading it and calling Epoch() continues exactly like this population would.
+    // The novelty search state is not saved: the behavior archive, the behavior store and index,
+    // and the archive bookkeeping used for eviction (the sparseness and merge weight of each entry,
+    // the candidate and eviction counts). InitPhenotypeBehaviorData() starts all of it again
+    // empty, so a resumed novelty search run starts with an empty archive.
+    void SaveCheckpoint(const char* a_FileName);
+
     //////////////////////
     // NEW STUFF
     std::vector<Species> m_TempSpecies; // useful in reproduction
@@ -257,10 +295,47 @@ public:
     // Not necessary to contain derived custom classes.
     std::vector< PhenotypeBehavior >* m_BehaviorArchive;
 
+    // The behaviors of the population, one for each individual
+    std::vector< PhenotypeBehavior >* m_BehaviorPopulation;
+
+    // If set, the behaviors are also kept as rows of this matrix and compared with
+    // its distance kernels instead of Distance_To(). Its first rows are the behaviors of
+    // m_BehaviorPopulation (copied from their m_Data when the sparseness is computed),
+    // the rest is the archive. New archive entries go only here, not to m_BehaviorArchive.
+    std::shared_ptr<BehaviorStore> m_BehaviorStore;
+
+    // For each archive behavior, its sparseness when it was added
+    // and how many behaviors were merged into it
+    std::vector<double> m_ArchiveSparseness;
+    std::vector<unsigned int> m_ArchiveWeights;
+
+    // How many behaviors qualified for the archive, and how many of them
+    // replaced or were merged into an entry because it was full (NoveltySearch_Archive_Capacity)
+    unsigned int m_NumArchiveCandidates;
+    unsigned int m_NumArchiveEvictions;
+
+    // The number of behaviors in the archive (in m_BehaviorStore if it is used)
+    unsigned int GetArchiveSize() const;
+
+    // About how many bytes the archive behaviors take
+    size_t GetArchiveMemoryUsage() const;
+
+    unsigned int GetArchiveCandidates() const { return m_NumArchiveCandidates; }
+    unsigned int GetArchiveEvictions() const { return m_NumArchiveEvictions; }
+
+    // Finds the nearest behaviors in the archive when computing the sparseness.
+    // InitPhenotypeBehaviorData() sets it according to NoveltySearch_Use_VPTree,
+    // replace it after that to use another kind of index.
+    std::shared_ptr<BehaviorIndex> m_BehaviorIndex;
+
     // Call this function to allocate memory for your custom
     // behaviors. This initializes everything.
     void InitPhenotypeBehaviorData(std::vector< PhenotypeBehavior >* a_population, std::vector< PhenotypeBehavior >* a_archive);
 
+    // Call after InitPhenotypeBehaviorData() to keep the behaviors in m_BehaviorStore.
+    // Every behavior must have a_Dimension values in its m_Data.
+    void InitBehaviorStore(unsigned int a_Dimension, BehaviorDistance a_Distance);
+
     // This is the main method performing novelty search.
     // Performs one reproduction and assigns novelty scores
     // based on the current population and the archive.
@@ -271,6 +346,11 @@ public:
 
     double ComputeSparseness(Genome& genome);
 
+    // Sets the fitness of every individual to its sparseness, on m_Parameters.NumThreads threads.
+    // PhenotypeBehavior::Distance_To() is taken to be symmetric and must be safe
+    // to call from several threads at once.
+    void RecomputeSparseness();
+
     // counters for archive stagnation
     unsigned int m_GensSinceLastArchiving;
     unsigned int m_QuickAddCounter;
@@ -84,6 +84,12 @@ BOOST_PYTHON_MODULE(_MultiNEAT)
         .value("BLENDED", BLENDED)
         ;
 
+    enum_<ArchiveEviction>("ArchiveEviction")
+        .value("RESERVOIR_EVICTION", RESERVOIR_EVICTION)
+        .value("LEAST_NOVEL_EVICTION", LEAST_NOVEL_EVICTION)
+        .value("MERGE_EVICTION", MERGE_EVICTION)
+        ;
+
 
 ///////////////////////////////////////////////////////////////////
 // RNG class
@@ -128,6 +134,10 @@ BOOST_PYTHON_MODULE(_MultiNEAT)
 
     void (NeuralNetwork::*NN_Save)(const char*) = &NeuralNetwork::Save;
     bool (NeuralNetwork::*NN_Load)(const char*) = &NeuralNetwork::Load;
+    bool (NeuralNetwork::*NN_SaveBinary)(const char*) = &NeuralNetwork::SaveBinary;
+    bool (NeuralNetwork::*NN_LoadBinary)(const char*) = &NeuralNetwork::LoadBinary;
+    void (NeuralNetwork::*NN_ActivateFeedForward)() = &NeuralNetwork::ActivateFeedForward;
+    double (EvolvableSubstrate::*ES_queryCPPN)(float, float, float, float) = &EvolvableSubstrate::queryCPPN;
     void (Genome::*Genome_Save)(const char*) = &Genome::Save;
     void (NeuralNetwork::*NN_Input)(list&) = &NeuralNetwork::Input_python_list;
     void (NeuralNetwork::*NN_Input_numpy)(numeric::array&) = &NeuralNetwork::Input_numpy;
@@ -159,6 +169,20 @@ BOOST_PYTHON_MODULE(_MultiNEAT)
             &NeuralNetwork::ActivateUseInternalBias)
             .def("ActivateLeaky",
             &NeuralNetwork::ActivateLeaky)
+            .def("Compile",
+            &NeuralNetwork::Compile)
+            .def("Invalidate",
+            &NeuralNetwork::Invalidate)
+            .def("ActivateFeedForward",
+            NN_ActivateFeedForward)
+            .def("IsFeedForward",
+            &NeuralNetwork::IsFeedForward)
+            .def("ActivateBatch",
+            &NeuralNetwork::ActivateBatch_python_list)
+            .def("SetFastActivation",
+            &NeuralNetwork::SetFastActivation)
+            .def("GetFastActivation",
+            &NeuralNetwork::GetFastActivation)
 
             .def("Adapt",
             &NeuralNetwork::Adapt)
@@ -181,6 +205,10 @@ BOOST_PYTHON_MODULE(_MultiNEAT)
             NN_Save)
             .def("Load",
             NN_Load)
+            .def("SaveBinary",
+            NN_SaveBinary)
+            .def("LoadBinary",
+            NN_LoadBinary)
 
             .def("Input",
             NN_Input)
@@ -239,7 +267,7 @@ BOOST_PYTHON_MODULE(_MultiNEAT)
 ///////////////////////////////////////////////////////////////////
 
     class_<Species>("Species", init<Genome const  &, int>())
-            .def("GetLeader", &Species::GetLeader)
+            .def("GetLeader", &Species::GetLeader, return_value_policy<copy_const_reference>())
             .def("NumIndividuals", &Species::NumIndividuals)
             .def("GensNoImprovement", &Species::GensNoImprovement)
             .def("ID", &Species::ID)
@@ -287,7 +315,9 @@ BOOST_PYTHON_MODULE(_MultiNEAT)
 
         class_<EvolvableSubstrate>("EvolvableSubstrate", init<const Parameters&, list, list>())
                 .def("generateSubstrate", &EvolvableSubstrate::generateSubstrate)
-                .def("queryCPPN", &EvolvableSubstrate::queryCPPN)
+                .def("queryCPPN", ES_queryCPPN)
+                .def("getCacheHits", &EvolvableSubstrate::getCacheHits)
+                .def("getCacheMisses", &EvolvableSubstrate::getCacheMisses)
                 .def("variance", &EvolvableSubstrate::variance)
                 .def("GetMinCPPNInputs", &EvolvableSubstrate::GetMinCPPNInputs)
                 .def("GetMinCPPNOutputs", &EvolvableSubstrate::GetMinCPPNOutputs)
@@ -302,6 +332,7 @@ BOOST_PYTHON_MODULE(_MultiNEAT)
             .def(init<char*>())
             .def("Epoch", &Population::Epoch)
             .def("Save", &Population::Save)
+            .def("SaveCheckpoint", &Population::SaveCheckpoint)
             .def("GetBestFitnessEver", &Population::GetBestFitnessEver)
             .def("GetBestGenome", &Population::GetBestGenome)
             .def("GetSearchMode", &Population::GetSearchMode)
@@ -328,6 +359,8 @@ BOOST_PYTHON_MODULE(_MultiNEAT)
             .def_readwrite("MaxSpecies", &Parameters::MaxSpecies)
             .def_readwrite("InnovationsForever", &Parameters::InnovationsForever)
             .def_readwrite("AllowClones", &Parameters::AllowClones)
+            .def_readwrite("NumThreads", &Parameters::NumThreads)
+            .def_readwrite("ParallelReproduction", &Parameters::ParallelReproduction)
             .def_readwrite("YoungAgeTreshold", &Parameters::YoungAgeTreshold)
             .def_readwrite("YoungAgeFitnessBoost", &Parameters::YoungAgeFitnessBoost)
             .def_readwrite("SpeciesDropoffAge", &Parameters::SpeciesMaxStagnation)
@@ -357,6 +390,9 @@ BOOST_PYTHON_MODULE(_MultiNEAT)
             .def_readwrite("NoveltySearch_Quick_Archiving_Min_Evaluations", &Parameters::NoveltySearch_Quick_Archiving_Min_Evaluations)
             .def_readwrite("NoveltySearch_Pmin_raising_multiplier", &Parameters::NoveltySearch_Pmin_raising_multiplier)
             .def_readwrite("NoveltySearch_Recompute_Sparseness_Each", &Parameters::NoveltySearch_Recompute_Sparseness_Each)
+            .def_readwrite("NoveltySearch_Use_VPTree", &Parameters::NoveltySearch_Use_VPTree)
+            .def_readwrite("NoveltySearch_Archive_Capacity", &Parameters::NoveltySearch_Archive_Capacity)
+            .def_readwrite("NoveltySearch_Archive_Eviction", &Parameters::NoveltySearch_Archive_Eviction)
             .def_readwrite("MutateAddNeuronProb", &Parameters::MutateAddNeuronProb)
             .def_readwrite("SplitRecurrent", &Parameters::SplitRecurrent)
             .def_readwrite("SplitLoopedRecurrent", &Parameters::SplitLoopedRecurrent)
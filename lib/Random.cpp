@@ -50,6 +50,14 @@ void RNG::TimeSeed()
     gen.seed(time(0));
 }
 
+// The seed sequence scrambles the whole key into the generator state,
+// so streams of neighbouring keys are not correlated
+void RNG::SeedStream(unsigned int a_Seed, unsigned int a_Generation, unsigned int a_Species, unsigned int a_Slot)
+{
+    boost::random::seed_seq t_key = {a_Seed, a_Generation, a_Species, a_Slot};
+    gen.seed(t_key);
+}
+
 // Returns randomly either 1 or -1
 int RNG::RandPosNeg()
 {
@@ -31,7 +31,12 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include <stdlib.h>
+#include <string>
+#include <sstream>
 #include <boost/random.hpp>
+#include <boost/serialization/access.hpp>
+#include <boost/serialization/split_member.hpp>
+#include <boost/serialization/string.hpp>
 
 
 
@@ -49,6 +54,11 @@ public:
     // Seeds the random number generator with time
     void TimeSeed();
 
+    // Seeds the random number generator with the stream of a key,
+    // for ex. (seed, generation, species, offspring slot).
+    // The same key always gives the same stream, different keys give unrelated ones.
+    void SeedStream(unsigned int a_Seed, unsigned int a_Generation, unsigned int a_Species, unsigned int a_Slot);
+
     // Returns randomly either 1 or -1
     int RandPosNeg();
 
@@ -67,6 +77,30 @@ public:
 
     // Returns an index given a vector of probabilities
     int Roulette(std::vector<double>& a_probs);
+
+private:
+    // The generator state is stored in its own text form,
+    // so a restored RNG continues the same sequence
+    friend class boost::serialization::access;
+    template<class Archive>
+    void save(Archive & ar, const unsigned int version) const
+    {
+        std::ostringstream t_os;
+        t_os << gen;
+        std::string t_state = t_os.str();
+        ar & t_state;
+    }
+
+    template<class Archive>
+    void load(Archive & ar, const unsigned int version)
+    {
+        std::string t_state;
+        ar & t_state;
+        std::istringstream t_is(t_state);
+        t_is >> gen;
+    }
+
+    BOOST_SERIALIZATION_SPLIT_MEMBER()
 };
 
 
@@ -93,6 +93,30 @@ Species& Species::operator=(const Species& a_S)
     return *this;
 }
 
+Species& Species::operator=(Species&& a_S)
+{
+    // self assignment guard
+    if (this != &a_S)
+    {
+        m_ID                    = a_S.m_ID;
+        m_Representative        = std::move(a_S.m_Representative);
+        m_BestGenome            = std::move(a_S.m_BestGenome);
+        m_BestSpecies            = a_S.m_BestSpecies;
+        m_WorstSpecies            = a_S.m_WorstSpecies;
+        m_BestFitness            = a_S.m_BestFitness;
+        m_GensNoImprovement        = a_S.m_GensNoImprovement;
+        m_Age                    = a_S.m_Age;
+        m_OffspringRqd            = a_S.m_OffspringRqd;
+        m_R                        = a_S.m_R;
+        m_G                        = a_S.m_G;
+        m_B                        = a_S.m_B;
+
+        m_Individuals = std::move(a_S.m_Individuals);
+    }
+
+    return *this;
+}
+
 
 
 // adds a new member to the species and updates variables
@@ -109,16 +133,22 @@ void Species::AddIndividual(Genome& a_Genome)
 
 
 // returns an individual randomly selected from the best N%
-Genome Species::GetIndividual(Parameters& a_Parameters, RNG& a_RNG) const
+const Genome& Species::GetIndividual(Parameters& a_Parameters, RNG& a_RNG) const
+{
+    return m_Individuals[GetIndividualIndex(a_Parameters, a_RNG)];
+}
+
+// returns the index of an individual randomly selected from the best N%
+unsigned int Species::GetIndividualIndex(Parameters& a_Parameters, RNG& a_RNG) const
 {
     ASSERT(m_Individuals.size() > 0);
 
     // Make a pool of only evaluated individuals!
-    std::vector<Genome> t_Evaluated;
+    std::vector<unsigned int> t_Evaluated;
     for(unsigned int i=0; i<m_Individuals.size(); i++)
     {
         if (m_Individuals[i].IsEvaluated())
-            t_Evaluated.push_back( m_Individuals[i] );
+            t_Evaluated.push_back( i );
     }
 
     ASSERT(t_Evaluated.size() > 0);
@@ -147,7 +177,7 @@ Genome Species::GetIndividual(Parameters& a_Parameters, RNG& a_RNG) const
         // roulette wheel selection
         std::vector<double> t_probs;
         for(uint i=0; i<t_Evaluated.size(); i++)
-            t_probs.push_back( t_Evaluated[i].GetFitness() );
+            t_probs.push_back( m_Individuals[t_Evaluated[i]].GetFitness() );
         t_chosen_one = a_RNG.Roulette(t_probs);
     }
 
@@ -156,7 +186,7 @@ Genome Species::GetIndividual(Parameters& a_Parameters, RNG& a_RNG) const
 
 
 // returns a completely random individual
-Genome Species::GetRandomIndividual(RNG& a_RNG) const
+const Genome& Species::GetRandomIndividual(RNG& a_RNG) const
 {
     if (m_Individuals.size() == 0) // no members yet, return representative
     {
@@ -171,7 +201,7 @@ Genome Species::GetRandomIndividual(RNG& a_RNG) const
 }
 
 // returns the leader (the member having the best fitness)
-Genome Species::GetLeader() const
+const Genome& Species::GetLeader() const
 {
     // Don't store the leader any more
     // Perform a search over the members and return the most fit member
@@ -199,7 +229,7 @@ Genome Species::GetLeader() const
 }
 
 
-Genome Species::GetRepresentative() const
+const Genome& Species::GetRepresentative() const
 {
     return m_Representative;
 }
@@ -364,86 +394,7 @@ void Species::Reproduce(Population &a_Pop, Parameters& a_Parameters, RNG& a_RNG)
             {
                 // this tells us if the baby is a result of mating
                 bool t_mated = false;
-
-                // There must be individuals there..
-                ASSERT(NumIndividuals() > 0);
-
-                // for a species of size 1 we can only mutate
-                // NOTE: but does it make sense since we know this is the champ?
-                if (NumIndividuals() == 1)
-                {
-                    t_baby = GetIndividual(a_Parameters, a_RNG);
-                    t_mated = false;
-                }
-                // else we can mate
-                else
-                {
-                    do // keep trying to mate until a good offspring is produced
-                    {
-                        Genome t_mom = GetIndividual(a_Parameters, a_RNG);
-
-                        // choose whether to mate at all
-                        // Do not allow crossover when in simplifying phase
-                        if ((a_RNG.RandFloat() < a_Parameters.CrossoverRate) && (a_Pop.GetSearchMode() != SIMPLIFYING))
-                        {
-                            // get the father
-                            Genome t_dad;
-                            bool t_interspecies = false;
-
-                            // There is a probability that the father may come from another species
-                            if ((a_RNG.RandFloat() < a_Parameters.InterspeciesCrossoverRate) && (a_Pop.m_Species.size()>1))
-                            {
-                                // Find different species (random one) // !!!!!!!!!!!!!!!!!
-                                int t_diffspec = a_RNG.RandInt(0, static_cast<int>(a_Pop.m_Species.size()-1));
-                                t_dad = a_Pop.m_Species[t_diffspec].GetIndividual(a_Parameters, a_RNG);
-                                t_interspecies = true;
-                            }
-                            else
-                            {
-                                // Mate within species
-                                t_dad = GetIndividual(a_Parameters, a_RNG);
-
-                                // The other parent should be a different one
-                                // number of tries to find different parent
-                                int t_tries = 32;
-                                if (!a_Parameters.AllowClones)
-                                    while(((t_mom.GetID() == t_dad.GetID()) || (t_mom.CompatibilityDistance(t_dad, a_Parameters) < 0.00001) ) && (t_tries--))
-                                    {
-                                        t_dad = GetIndividual(a_Parameters, a_RNG);
-                                    }
-                                else
-                                    while(((t_mom.GetID() == t_dad.GetID()) ) && (t_tries--))
-                                    {
-                                        t_dad = GetIndividual(a_Parameters, a_RNG);
-                                    }
-                                t_interspecies = false;
-                            }
-
-                            // OK we have both mom and dad so mate them
-                            // Choose randomly one of two types of crossover
-                            if (a_RNG.RandFloat() < a_Parameters.MultipointCrossoverRate)
-                            {
-                                t_baby = t_mom.Mate( t_dad, false, t_interspecies, a_RNG);
-                            }
-                            else
-                            {
-                                t_baby = t_mom.Mate( t_dad, true, t_interspecies, a_RNG);
-                            }
-
-                            t_mated = true;
-                        }
-                        // don't mate - reproduce the mother asexually
-                        else
-                        {
-                            t_baby = t_mom;
-                            t_mated = false;
-                        }
-
-                    } while (t_baby.HasDeadEnds() || (t_baby.NumLinks() == 0));
-                    // in case of dead ends after crossover we will repeat crossover
-                    // until it works
-                }
-
+                MateOffspring(a_Pop, t_baby, t_mated, a_Parameters, a_RNG);
 
                 // Mutate the baby
                 if ((!t_mated) || (a_RNG.RandFloat() < a_Parameters.OverallMutationRate))
@@ -451,25 +402,8 @@ void Species::Reproduce(Population &a_Pop, Parameters& a_Parameters, RNG& a_RNG)
 
                 // Check if this baby is already present somewhere in the offspring
                 // we don't want that
-                t_baby_exists_in_pop = false;
                 // Unless of course, we want
-                if (!a_Parameters.AllowClones)
-                {
-                    for(unsigned int i=0; i<a_Pop.m_TempSpecies.size(); i++)
-                    {
-                        for(unsigned int j=0; j<a_Pop.m_TempSpecies[i].m_Individuals.size(); j++)
-                        {
-                            if (
-                                (t_baby.CompatibilityDistance(a_Pop.m_TempSpecies[i].m_Individuals[j], a_Parameters) < 0.00001) // identical genome?
-                               )
-
-                            {
-                                t_baby_exists_in_pop = true;
-                                break;
-                            }
-                        }
-                    }
-                }
+                t_baby_exists_in_pop = (!a_Parameters.AllowClones) && ExistsInOffspring(a_Pop, t_baby, a_Parameters);
             }
             while (t_baby_exists_in_pop); // end do
         }
@@ -484,73 +418,267 @@ void Species::Reproduce(Population &a_Pop, Parameters& a_Parameters, RNG& a_RNG)
 
 
         // We have a new offspring now
-        // give the offspring a new ID
-        t_baby.SetID(a_Pop.GetNextGenomeID());
-        a_Pop.IncrementNextGenomeID();
-
-        // sort the baby's genes
-        t_baby.SortGenes();
-
-        // clear the baby's fitness
-        t_baby.SetFitness(0);
-        t_baby.SetAdjFitness(0);
-        t_baby.SetOffspringAmount(0);
+        PlaceOffspring(a_Pop, t_baby, a_Parameters);
+    }
+}
 
-        t_baby.ResetEvaluated();
 
 
-        //////////////////////////////////
-        // put the baby to its species  //
-        //////////////////////////////////
 
-        // before Reproduce() is invoked, it is assumed that a
-        // clone of the population exists with the name of m_TempSpecies
-        // we will store results there.
-        // after all reproduction completes, the original species will be replaced back
 
-        bool t_found = false;
-        std::vector<Species>::iterator t_cur_species = a_Pop.m_TempSpecies.begin();
+// Chooses the parents and mates them, or picks one to be mutated.
+// Reads the population only, so it can run for many babies at once.
+void Species::MateOffspring(Population& a_Pop, Genome& a_Baby, bool& a_Mated, Parameters& a_Parameters, RNG& a_RNG) const
+{
+    // There must be individuals there..
+    ASSERT(m_Individuals.size() > 0);
 
-        // No species yet?
-        if (t_cur_species == a_Pop.m_TempSpecies.end())
-        {
-            // create the first species and place the baby there
-            a_Pop.m_TempSpecies.push_back( Species(t_baby, a_Pop.GetNextSpeciesID()));
-            a_Pop.IncrementNextSpeciesID();
-        }
-        else
+    // for a species of size 1 we can only mutate
+    // NOTE: but does it make sense since we know this is the champ?
+    if (m_Individuals.size() == 1)
+    {
+        a_Baby = GetIndividual(a_Parameters, a_RNG);
+        a_Mated = false;
+    }
+    // else we can mate
+    else
+    {
+        do // keep trying to mate until a good offspring is produced
         {
-            // try to find a compatible species
-            Genome t_to_compare = t_cur_species->GetRepresentative();
+            // the parents are only referenced, the species don't change while mating
+            const Genome& t_mom = GetIndividual(a_Parameters, a_RNG);
 
-            t_found = false;
-            while((t_cur_species != a_Pop.m_TempSpecies.end()) && (!t_found))
+            // choose whether to mate at all
+            // Do not allow crossover when in simplifying phase
+            if ((a_RNG.RandFloat() < a_Parameters.CrossoverRate) && (a_Pop.GetSearchMode() != SIMPLIFYING))
             {
-                if (t_baby.IsCompatibleWith( t_to_compare, a_Parameters))
+                // get the father
+                const Genome* t_dad = NULL;
+                bool t_interspecies = false;
+
+                // There is a probability that the father may come from another species
+                if ((a_RNG.RandFloat() < a_Parameters.InterspeciesCrossoverRate) && (a_Pop.m_Species.size()>1))
+                {
+                    // Find different species (random one) // !!!!!!!!!!!!!!!!!
+                    int t_diffspec = a_RNG.RandInt(0, static_cast<int>(a_Pop.m_Species.size()-1));
+                    t_dad = &a_Pop.m_Species[t_diffspec].GetIndividual(a_Parameters, a_RNG);
+                    t_interspecies = true;
+                }
+                else
+                {
+                    // Mate within species
+                    t_dad = &GetIndividual(a_Parameters, a_RNG);
+
+                    // The other parent should be a different one
+                    // number of tries to find different parent
+                    int t_tries = 32;
+                    if (!a_Parameters.AllowClones)
+                        while(((t_mom.GetID() == t_dad->GetID()) || (t_mom.CompatibilityDistance(*t_dad, a_Parameters, 0.00001) < 0.00001) ) && (t_tries--))
+                        {
+                            t_dad = &GetIndividual(a_Parameters, a_RNG);
+                        }
+                    else
+                        while(((t_mom.GetID() == t_dad->GetID()) ) && (t_tries--))
+                        {
+                            t_dad = &GetIndividual(a_Parameters, a_RNG);
+                        }
+                    t_interspecies = false;
+                }
+
+                // OK we have both mom and dad so mate them
+                // Choose randomly one of two types of crossover
+                if (a_RNG.RandFloat() < a_Parameters.MultipointCrossoverRate)
                 {
-                    // found a compatible species
-                    t_cur_species->AddIndividual(t_baby);
-                    t_found = true; // the search is over
+                    a_Baby = t_mom.Mate( *t_dad, false, t_interspecies, a_RNG);
                 }
                 else
                 {
-                    // keep searching for a matching species
-                    t_cur_species++;
-                    if (t_cur_species != a_Pop.m_TempSpecies.end())
-                    {
-                        t_to_compare = t_cur_species->GetRepresentative();
-                    }
+                    a_Baby = t_mom.Mate( *t_dad, true, t_interspecies, a_RNG);
+                }
+
+                a_Mated = true;
+            }
+            // don't mate - reproduce the mother asexually
+            else
+            {
+                a_Baby = t_mom;
+                a_Mated = false;
+            }
+
+        } while (a_Baby.HasDeadEnds() || (a_Baby.NumLinks() == 0));
+        // in case of dead ends after crossover we will repeat crossover
+        // until it works
+    }
+}
+
+
+// Tells if an identical genome is already in the new population
+bool Species::ExistsInOffspring(Population& a_Pop, Genome& a_Baby, Parameters& a_Parameters) const
+{
+    for(unsigned int i=0; i<a_Pop.m_TempSpecies.size(); i++)
+    {
+        for(unsigned int j=0; j<a_Pop.m_TempSpecies[i].m_Individuals.size(); j++)
+        {
+            if (a_Baby.CompatibilityDistance(a_Pop.m_TempSpecies[i].m_Individuals[j], a_Parameters, 0.00001) < 0.00001) // identical genome?
+            {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+
+// Gives the baby its ID and puts it in its species of the new population
+void Species::PlaceOffspring(Population& a_Pop, Genome& a_Baby, Parameters& a_Parameters) const
+{
+    // give the offspring a new ID
+    a_Baby.SetID(a_Pop.GetNextGenomeID());
+    a_Pop.IncrementNextGenomeID();
+
+    // sort the baby's genes
+    a_Baby.SortGenes();
+
+    // clear the baby's fitness
+    a_Baby.SetFitness(0);
+    a_Baby.SetAdjFitness(0);
+    a_Baby.SetOffspringAmount(0);
+
+    a_Baby.ResetEvaluated();
+
+
+    //////////////////////////////////
+    // put the baby to its species  //
+    //////////////////////////////////
+
+    // before Reproduce() is invoked, it is assumed that a
+    // clone of the population exists with the name of m_TempSpecies
+    // we will store results there.
+    // after all reproduction completes, the original species will be replaced back
+
+    bool t_found = false;
+    std::vector<Species>::iterator t_cur_species = a_Pop.m_TempSpecies.begin();
+
+    // No species yet?
+    if (t_cur_species == a_Pop.m_TempSpecies.end())
+    {
+        // create the first species and place the baby there
+        a_Pop.m_TempSpecies.push_back( Species(a_Baby, a_Pop.GetNextSpeciesID()));
+        a_Pop.IncrementNextSpeciesID();
+    }
+    else
+    {
+        // try to find a compatible species
+        const Genome* t_to_compare = &t_cur_species->GetRepresentative();
+
+        t_found = false;
+        while((t_cur_species != a_Pop.m_TempSpecies.end()) && (!t_found))
+        {
+            if (a_Baby.IsCompatibleWith( *t_to_compare, a_Parameters))
+            {
+                // found a compatible species
+                t_cur_species->AddIndividual(a_Baby);
+                t_found = true; // the search is over
+            }
+            else
+            {
+                // keep searching for a matching species
+                t_cur_species++;
+                if (t_cur_species != a_Pop.m_TempSpecies.end())
+                {
+                    t_to_compare = &t_cur_species->GetRepresentative();
                 }
             }
+        }
+
+        // if couldn't find a match, make a new species
+        if (!t_found)
+        {
+            a_Pop.m_TempSpecies.push_back( Species(a_Baby, a_Pop.GetNextSpeciesID()));
+            a_Pop.IncrementNextSpeciesID();
+        }
+    }
+}
+
+
+// The first half of the parallel reproduction. Everything random comes from the
+// offspring's own stream, so the result does not depend on which thread runs it.
+void Species::DraftOffspring(unsigned int a_Slot, unsigned int a_Seed, unsigned int a_Generation,
+                             Population& a_Pop, Parameters& a_Parameters, Offspring& a_Offspring) const
+{
+    a_Offspring.m_RNG.SeedStream(a_Seed, a_Generation, m_ID, a_Slot);
+    a_Offspring.m_PendingMutation = -1;
+
+    // the first slot is for the champ
+    a_Offspring.m_Champion = (a_Slot == 0);
+    if (a_Offspring.m_Champion)
+    {
+        a_Offspring.m_Baby = m_Individuals[0];
+        return;
+    }
+
+    bool t_mated = false;
+    MateOffspring(a_Pop, a_Offspring.m_Baby, t_mated, a_Parameters, a_Offspring.m_RNG);
+
+    if ((!t_mated) || (a_Offspring.m_RNG.RandFloat() < a_Parameters.OverallMutationRate))
+    {
+        // same as MutateGenome(), but stops at a mutation that changes the innovation database
+        std::vector<double> t_mut_probs = MutationProbabilities(false, a_Pop, a_Parameters);
+        bool t_mutation_success = false;
+        while (t_mutation_success == false)
+        {
+            int t_mutation = a_Offspring.m_RNG.Roulette(t_mut_probs);
+            if (NeedsInnovations(t_mutation))
+            {
+                a_Offspring.m_PendingMutation = t_mutation;
+                break;
+            }
+
+            t_mutation_success = ApplyMutation(t_mutation, a_Pop, a_Offspring.m_Baby, a_Parameters, a_Offspring.m_RNG);
+        }
+    }
+}
 
-            // if couldn't find a match, make a new species
-            if (!t_found)
+
+// The second half of the parallel reproduction, called for the slots in order
+void Species::FinishOffspring(Population& a_Pop, Parameters& a_Parameters, Offspring& a_Offspring) const
+{
+    Genome& t_baby = a_Offspring.m_Baby;
+    RNG& t_rng = a_Offspring.m_RNG;
+
+    if (!a_Offspring.m_Champion)
+    {
+        if (a_Offspring.m_PendingMutation >= 0)
+        {
+            std::vector<double> t_mut_probs = MutationProbabilities(false, a_Pop, a_Parameters);
+            bool t_mutation_success = ApplyMutation(a_Offspring.m_PendingMutation, a_Pop, t_baby, a_Parameters, t_rng);
+            while (t_mutation_success == false)
             {
-                a_Pop.m_TempSpecies.push_back( Species(t_baby, a_Pop.GetNextSpeciesID()));
-                a_Pop.IncrementNextSpeciesID();
+                t_mutation_success = ApplyMutation(t_rng.Roulette(t_mut_probs), a_Pop, t_baby, a_Parameters, t_rng);
             }
         }
+
+        // a clone is made again, like in Reproduce()
+        bool t_baby_exists_in_pop = (!a_Parameters.AllowClones) && ExistsInOffspring(a_Pop, t_baby, a_Parameters);
+        while (t_baby_exists_in_pop)
+        {
+            bool t_mated = false;
+            MateOffspring(a_Pop, t_baby, t_mated, a_Parameters, t_rng);
+
+            if ((!t_mated) || (t_rng.RandFloat() < a_Parameters.OverallMutationRate))
+                MutateGenome(true, a_Pop, t_baby, a_Parameters, t_rng);
+
+            t_baby_exists_in_pop = ExistsInOffspring(a_Pop, t_baby, a_Parameters);
+        }
+    }
+
+    if ((t_baby.NumLinks() == 0) || t_baby.HasDeadEnds())
+    {
+        t_baby = GetIndividual(a_Parameters, t_rng);
     }
+
+    PlaceOffspring(a_Pop, t_baby, a_Parameters);
 }
 
 
@@ -609,14 +737,15 @@ Genome Species::ReproduceOne(Population& a_Pop, Parameters& a_Parameters, RNG& a
     // else we can mate
     else
     {
-        Genome t_mom = GetIndividual(a_Parameters, a_RNG);
+        // the parents are only referenced, the species don't change while mating
+        const Genome& t_mom = GetIndividual(a_Parameters, a_RNG);
 
         // choose whether to mate at all
         // Do not allow crossover when in simplifying phase
         if ((a_RNG.RandFloat() < a_Parameters.CrossoverRate) && (a_Pop.GetSearchMode() != SIMPLIFYING))
         {
             // get the father
-            Genome t_dad;
+            const Genome* t_dad = NULL;
             bool t_interspecies = false;
 
             // There is a probability that the father may come from another species
@@ -633,23 +762,23 @@ Genome Species::ReproduceOne(Population& a_Pop, Parameters& a_Parameters, RNG& a
                 while ((a_Pop.m_Species[t_diffspec].m_AverageFitness == 0) && (t_giveup--));
 
                 if (a_Pop.m_Species[t_diffspec].m_AverageFitness == 0)
-                    t_dad = GetIndividual(a_Parameters, a_RNG);
+                    t_dad = &GetIndividual(a_Parameters, a_RNG);
                 else
-                    t_dad = a_Pop.m_Species[t_diffspec].GetIndividual(a_Parameters, a_RNG);
+                    t_dad = &a_Pop.m_Species[t_diffspec].GetIndividual(a_Parameters, a_RNG);
 
                 t_interspecies = true;
             }
             else
             {
                 // Mate within species
-                t_dad = GetIndividual(a_Parameters, a_RNG);
+                t_dad = &GetIndividual(a_Parameters, a_RNG);
 
                 // The other parent should be a different one
                 // number of tries to find different parent
                 int t_tries = 32;
-                while(((t_mom.GetID() == t_dad.GetID()) || ((!a_Parameters.AllowClones) && (t_mom.CompatibilityDistance(t_dad, a_Parameters) <= 0.00001)) ) && (t_tries--))
+                while(((t_mom.GetID() == t_dad->GetID()) || ((!a_Parameters.AllowClones) && (t_mom.CompatibilityDistance(*t_dad, a_Parameters, 0.00001) <= 0.00001)) ) && (t_tries--))
                 {
-                    t_dad = GetIndividual(a_Parameters, a_RNG);
+                    t_dad = &GetIndividual(a_Parameters, a_RNG);
                 }
                 t_interspecies = false;
             }
@@ -658,11 +787,11 @@ Genome Species::ReproduceOne(Population& a_Pop, Parameters& a_Parameters, RNG& a
             // Choose randomly one of two types of crossover
             if (a_RNG.RandFloat() < a_Parameters.MultipointCrossoverRate)
             {
-                t_baby = t_mom.Mate( t_dad, false, t_interspecies, a_RNG);
+                t_baby = t_mom.Mate( *t_dad, false, t_interspecies, a_RNG);
             }
             else
             {
-                t_baby = t_mom.Mate( t_dad, true, t_interspecies, a_RNG);
+                t_baby = t_mom.Mate( *t_dad, true, t_interspecies, a_RNG);
             }
             t_mated = true;
         }
@@ -721,20 +850,10 @@ Genome Species::ReproduceOne(Population& a_Pop, Parameters& a_Parameters, RNG& a
 }
 
 
-// Mutates a genome
-void Species::MutateGenome( bool t_baby_is_clone, Population &a_Pop, Genome &t_baby, Parameters& a_Parameters, RNG& a_RNG )
+// The probabilities of the mutation types for the roulette.
+// All mutations are mutually exclusive - see MutateGenome()
+std::vector<double> Species::MutationProbabilities(bool a_BabyIsClone, Population& a_Pop, Parameters& a_Parameters) const
 {
-#if 1
-    // NEW version:
-    // All mutations are mutually exclusive - can't have 2 mutations at once
-    // for example a weight mutation and time constants mutation
-    // or add link and add node and then weight mutation
-    // We will perform roulette wheel selection to choose the type of mutation and will mutate the baby
-    // This method guarantees that the baby will be mutated at least with one mutation
-    enum MutationTypes {ADD_NODE = 0, ADD_LINK, REMOVE_NODE, REMOVE_LINK, CHANGE_ACTIVATION_FUNCTION,
-                        MUTATE_WEIGHTS, MUTATE_ACTIVATION_A, MUTATE_ACTIVATION_B, MUTATE_TIMECONSTS, MUTATE_BIASES
-                       };
-    std::vector<int> t_muts;
     std::vector<double> t_mut_probs;
 
     // ADD_NODE;
@@ -769,117 +888,142 @@ void Species::MutateGenome( bool t_baby_is_clone, Population &a_Pop, Genome &t_b
 
     // Special consideration for phased searching - do not allow certain mutations depending on the search mode
     // also don't use additive mutations if we just want to get rid of the clones
-    if ((a_Pop.GetSearchMode() == SIMPLIFYING) || t_baby_is_clone)
+    if ((a_Pop.GetSearchMode() == SIMPLIFYING) || a_BabyIsClone)
     {
         t_mut_probs[ADD_NODE] = 0; // add node
         t_mut_probs[ADD_LINK] = 0; // add link
     }
-    if ((a_Pop.GetSearchMode() == COMPLEXIFYING) || t_baby_is_clone)
+    if ((a_Pop.GetSearchMode() == COMPLEXIFYING) || a_BabyIsClone)
     {
         t_mut_probs[REMOVE_NODE] = 0; // rem node
         t_mut_probs[REMOVE_LINK] = 0; // rem link
     }
 
+    return t_mut_probs;
+}
+
+
+// Applies one mutation of the given type and returns if it succeeded
+bool Species::ApplyMutation(int a_Mutation, Population& a_Pop, Genome& a_Baby, Parameters& a_Parameters, RNG& a_RNG) const
+{
     bool t_mutation_success = false;
 
-    // repeat until successful
-    while (t_mutation_success == false)
+    // Now mutate based on the choice
+    switch(a_Mutation)
     {
-        int ChosenMutation = a_RNG.Roulette(t_mut_probs);
+    case ADD_NODE:
+        t_mutation_success = a_Baby.Mutate_AddNeuron(a_Pop.AccessInnovationDatabase(), a_Parameters, a_RNG);
+        break;
 
-        // Now mutate based on the choice
-        switch(ChosenMutation)
-        {
-        case ADD_NODE:
-            t_mutation_success = t_baby.Mutate_AddNeuron(a_Pop.AccessInnovationDatabase(), a_Parameters, a_RNG);
-            break;
+    case ADD_LINK:
+        t_mutation_success = a_Baby.Mutate_AddLink(a_Pop.AccessInnovationDatabase(), a_Parameters, a_RNG);
+        break;
 
-        case ADD_LINK:
-            t_mutation_success = t_baby.Mutate_AddLink(a_Pop.AccessInnovationDatabase(), a_Parameters, a_RNG);
-            break;
+    case REMOVE_NODE:
+        t_mutation_success = a_Baby.Mutate_RemoveSimpleNeuron(a_Pop.AccessInnovationDatabase(), a_RNG);
+        break;
 
-        case REMOVE_NODE:
-            t_mutation_success = t_baby.Mutate_RemoveSimpleNeuron(a_Pop.AccessInnovationDatabase(), a_RNG);
-            break;
+    case REMOVE_LINK:
+    {
+        // Keep doing this mutation until it is sure that the baby will not
+        // end up having dead ends or no links
+        Genome t_saved_baby = a_Baby;
+        bool t_no_links = false, t_has_dead_ends = false;
 
-        case REMOVE_LINK:
+        int t_tries = 128;
+        do
         {
-            // Keep doing this mutation until it is sure that the baby will not
-            // end up having dead ends or no links
-            Genome t_saved_baby = t_baby;
-            bool t_no_links = false, t_has_dead_ends = false;
-
-            int t_tries = 128;
-            do
+            t_tries--;
+            if (t_tries <= 0)
             {
-                t_tries--;
-                if (t_tries <= 0)
-                {
-                    t_saved_baby = t_baby;
-                    break; // give up
-                }
+                t_saved_baby = a_Baby;
+                break; // give up
+            }
 
-                t_saved_baby = t_baby;
-                t_mutation_success = t_saved_baby.Mutate_RemoveLink(a_RNG);
+            t_saved_baby = a_Baby;
+            t_mutation_success = t_saved_baby.Mutate_RemoveLink(a_RNG);
 
-                t_no_links = t_has_dead_ends = false;
+            t_no_links = t_has_dead_ends = false;
 
-                if (t_saved_baby.NumLinks() == 0)
-                    t_no_links = true;
+            if (t_saved_baby.NumLinks() == 0)
+                t_no_links = true;
 
-                t_has_dead_ends = t_saved_baby.HasDeadEnds();
+            t_has_dead_ends = t_saved_baby.HasDeadEnds();
 
-            }
-            while(t_no_links || t_has_dead_ends);
+        }
+        while(t_no_links || t_has_dead_ends);
 
-            t_baby = t_saved_baby;
+        a_Baby = t_saved_baby;
 
-            // debugger trap
-            if (t_baby.NumLinks() == 0)
-            {
-                std::cerr << "No links in baby after mutation" << std::endl;
-            }
-            if (t_baby.HasDeadEnds())
-            {
-                std::cerr << "Dead ends in baby after mutation" << std::endl;
-            }
+        // debugger trap
+        if (a_Baby.NumLinks() == 0)
+        {
+            std::cerr << "No links in baby after mutation" << std::endl;
+        }
+        if (a_Baby.HasDeadEnds())
+        {
+            std::cerr << "Dead ends in baby after mutation" << std::endl;
         }
+    }
+    break;
+
+    case CHANGE_ACTIVATION_FUNCTION:
+        a_Baby.Mutate_NeuronActivation_Type(a_Parameters, a_RNG);
+        t_mutation_success = true;
         break;
 
-        case CHANGE_ACTIVATION_FUNCTION:
-            t_baby.Mutate_NeuronActivation_Type(a_Parameters, a_RNG);
-            t_mutation_success = true;
-            break;
-
-        case MUTATE_WEIGHTS:
-            t_baby.Mutate_LinkWeights(a_Parameters, a_RNG);
-            t_mutation_success = true;
-            break;
-
-        case MUTATE_ACTIVATION_A:
-            t_baby.Mutate_NeuronActivations_A(a_Parameters, a_RNG);
-            t_mutation_success = true;
-            break;
-
-        case MUTATE_ACTIVATION_B:
-            t_baby.Mutate_NeuronActivations_B(a_Parameters, a_RNG);
-            t_mutation_success = true;
-            break;
-
-        case MUTATE_TIMECONSTS:
-            t_baby.Mutate_NeuronTimeConstants(a_Parameters, a_RNG);
-            t_mutation_success = true;
-            break;
-
-        case MUTATE_BIASES:
-            t_baby.Mutate_NeuronBiases(a_Parameters, a_RNG);
-            t_mutation_success = true;
-            break;
-
-        default:
-            t_mutation_success = false;
-            break;
-        }
+    case MUTATE_WEIGHTS:
+        a_Baby.Mutate_LinkWeights(a_Parameters, a_RNG);
+        t_mutation_success = true;
+        break;
+
+    case MUTATE_ACTIVATION_A:
+        a_Baby.Mutate_NeuronActivations_A(a_Parameters, a_RNG);
+        t_mutation_success = true;
+        break;
+
+    case MUTATE_ACTIVATION_B:
+        a_Baby.Mutate_NeuronActivations_B(a_Parameters, a_RNG);
+        t_mutation_success = true;
+        break;
+
+    case MUTATE_TIMECONSTS:
+        a_Baby.Mutate_NeuronTimeConstants(a_Parameters, a_RNG);
+        t_mutation_success = true;
+        break;
+
+    case MUTATE_BIASES:
+        a_Baby.Mutate_NeuronBiases(a_Parameters, a_RNG);
+        t_mutation_success = true;
+        break;
+
+    default:
+        t_mutation_success = false;
+        break;
+    }
+
+    return t_mutation_success;
+}
+
+
+// Mutates a genome
+void Species::MutateGenome( bool t_baby_is_clone, Population &a_Pop, Genome &t_baby, Parameters& a_Parameters, RNG& a_RNG ) const
+{
+#if 1
+    // NEW version:
+    // All mutations are mutually exclusive - can't have 2 mutations at once
+    // for example a weight mutation and time constants mutation
+    // or add link and add node and then weight mutation
+    // We will perform roulette wheel selection to choose the type of mutation and will mutate the baby
+    // This method guarantees that the baby will be mutated at least with one mutation
+    std::vector<double> t_mut_probs = MutationProbabilities(t_baby_is_clone, a_Pop, a_Parameters);
+
+    bool t_mutation_success = false;
+
+    // repeat until successful
+    while (t_mutation_success == false)
+    {
+        t_mutation_success = ApplyMutation(a_RNG.Roulette(t_mut_probs), a_Pop, t_baby, a_Parameters, a_RNG);
     }
 
 
@@ -42,6 +42,23 @@ namespace NEAT
 // forward
 class Population;
 
+// An offspring of the parallel reproduction. Species::DraftOffspring() makes it on any
+// thread, Species::FinishOffspring() finishes it in the order of the slots.
+struct Offspring
+{
+    Genome m_Baby;
+
+    // the random stream of this offspring, used by both halves
+    RNG m_RNG;
+
+    // the species champion, copied unchanged
+    bool m_Champion;
+
+    // a mutation that needs the innovation database and is left for
+    // FinishOffspring(), -1 if there is none
+    int m_PendingMutation;
+};
+
 //////////////////////////////////////////////
 // The Species class
 //////////////////////////////////////////////
@@ -74,6 +91,52 @@ private:
     // the next population
     double m_OffspringRqd;
 
+    // Only used when loading from an archive
+    Species() {}
+
+    enum MutationTypes {ADD_NODE = 0, ADD_LINK, REMOVE_NODE, REMOVE_LINK, CHANGE_ACTIVATION_FUNCTION,
+                        MUTATE_WEIGHTS, MUTATE_ACTIVATION_A, MUTATE_ACTIVATION_B, MUTATE_TIMECONSTS, MUTATE_BIASES
+                       };
+
+    // the probabilities of the mutation types for the roulette
+    std::vector<double> MutationProbabilities(bool a_BabyIsClone, Population& a_Pop, Parameters& a_Parameters) const;
+
+    // Applies one mutation of the given type and returns if it succeeded
+    bool ApplyMutation(int a_Mutation, Population& a_Pop, Genome& a_Baby, Parameters& a_Parameters, RNG& a_RNG) const;
+
+    // Only the additive mutations and neuron removal touch the innovation database
+    static bool NeedsInnovations(int a_Mutation) { return (a_Mutation == ADD_NODE) || (a_Mutation == ADD_LINK) || (a_Mutation == REMOVE_NODE); }
+
+    // Chooses the parents and mates them, or picks one to be mutated.
+    // Reads the population only.
+    void MateOffspring(Population& a_Pop, Genome& a_Baby, bool& a_Mated, Parameters& a_Parameters, RNG& a_RNG) const;
+
+    // Tells if an identical genome is already in the new population
+    bool ExistsInOffspring(Population& a_Pop, Genome& a_Baby, Parameters& a_Parameters) const;
+
+    // Gives the baby its ID and puts it in its species of the new population
+    void PlaceOffspring(Population& a_Pop, Genome& a_Baby, Parameters& a_Parameters) const;
+
+    friend class boost::serialization::access;
+    template<class Archive>
+    void serialize(Archive & ar, const unsigned int version)
+    {
+        ar & m_ID;
+        ar & m_Representative;
+        ar & m_BestSpecies;
+        ar & m_WorstSpecies;
+        ar & m_Age;
+        ar & m_OffspringRqd;
+        ar & m_BestFitness;
+        ar & m_BestGenome;
+        ar & m_GensNoImprovement;
+        ar & m_R;
+        ar & m_G;
+        ar & m_B;
+        ar & m_Individuals;
+        ar & m_AverageFitness;
+    }
+
 public:
 
     // best fitness found so far by this species
@@ -98,9 +161,17 @@ public:
     // initializes a species with a leader genome and an ID number
     Species(const Genome& a_Seed, int a_id);
 
+    Species(const Species& a_g) = default;
+
+    // move constructor, takes over the genomes without copying them
+    Species(Species&& a_g) = default;
+
     // assignment operator
     Species& operator=(const Species& a_g);
 
+    // move assignment operator
+    Species& operator=(Species&& a_g);
+
     // comparison operator (nessesary for boost::python)
     // todo: implement a better comparison technique
     bool operator==(Species const& other) const { return m_ID == other.m_ID; }
@@ -127,24 +198,27 @@ public:
     int ID() { return m_ID; }
     int GensNoImprovement() { return m_GensNoImprovement; }
     int Age() { return m_Age; }
-    Genome GetIndividualByIdx(int a_idx) const { return (m_Individuals[a_idx]); }
+    const Genome& GetIndividualByIdx(int a_idx) const { return (m_Individuals[a_idx]); }
     bool IsBestSpecies() const { return m_BestSpecies; }
     bool IsWorstSpecies() const { return m_WorstSpecies; }
     void SetRepresentative(Genome& a_G) { m_Representative = a_G; }
 
     // returns the leader (the member having the best fitness, representing the species)
-    Genome GetLeader() const;
+    const Genome& GetLeader() const;
 
-    Genome GetRepresentative() const;
+    const Genome& GetRepresentative() const;
 
     // adds a new member to the species and updates variables
     void AddIndividual(Genome& a_New);
 
     // returns an individual randomly selected from the best N%
-    Genome GetIndividual(Parameters& a_Parameters, RNG& a_RNG) const;
+    const Genome& GetIndividual(Parameters& a_Parameters, RNG& a_RNG) const;
+
+    // same, but returns its index in m_Individuals
+    unsigned int GetIndividualIndex(Parameters& a_Parameters, RNG& a_RNG) const;
 
     // returns a completely random individual
-    Genome GetRandomIndividual(RNG& a_RNG) const;
+    const Genome& GetRandomIndividual(RNG& a_RNG) const;
 
     // calculates how many babies this species will spawn in total
     void CountOffspring();
@@ -169,7 +243,16 @@ public:
     // Reproduction.
     void Reproduce(Population& a_Pop, Parameters& a_Parameters, RNG& a_RNG);
 
-    void MutateGenome( bool t_baby_is_clone, Population &a_Pop, Genome &t_baby, Parameters& a_Parameters, RNG& a_RNG);
+    // The parallel reproduction, in two halves.
+    // DraftOffspring() may run for all slots at once - it seeds a_Offspring.m_RNG from the key
+    // (a_Seed, a_Generation, species ID, a_Slot), mates and mutates the baby, except for the
+    // mutations that need the innovation database. FinishOffspring() must be called for the
+    // slots in order, it does those mutations, replaces clones and places the baby.
+    void DraftOffspring(unsigned int a_Slot, unsigned int a_Seed, unsigned int a_Generation,
+                        Population& a_Pop, Parameters& a_Parameters, Offspring& a_Offspring) const;
+    void FinishOffspring(Population& a_Pop, Parameters& a_Parameters, Offspring& a_Offspring) const;
+
+    void MutateGenome( bool t_baby_is_clone, Population &a_Pop, Genome &t_baby, Parameters& a_Parameters, RNG& a_RNG) const;
 
     // Removes all individuals
     void Clear()
@@ -152,5 +152,123 @@ unsigned int Substrate::GetMinCPPNOutputs()
     return 1;
 }
 
+std::vector<bool> Substrate::GetLinkFlags() const
+{
+    std::vector<bool> t_flags;
+    t_flags.push_back(m_allow_input_hidden_links);
+    t_flags.push_back(m_allow_input_output_links);
+    t_flags.push_back(m_allow_hidden_hidden_links);
+    t_flags.push_back(m_allow_hidden_output_links);
+    t_flags.push_back(m_allow_output_hidden_links);
+    t_flags.push_back(m_allow_output_output_links);
+    t_flags.push_back(m_allow_looped_hidden_links);
+    t_flags.push_back(m_allow_looped_output_links);
+    return t_flags;
+}
+
+void Substrate::UpdateLinkCache()
+{
+    std::lock_guard<std::mutex> t_lock(m_cache_mutex.m_Mutex);
+
+    std::vector<bool> t_flags = GetLinkFlags();
+    if (m_cache_valid &&
+        (t_flags == m_cached_flags) &&
+        (_input_coords == m_cached_input_coords) &&
+        (_hidden_coords == m_cached_hidden_coords) &&
+        (_output_coords == m_cached_output_coords))
+    {
+        return;
+    }
+
+    m_cached_flags = t_flags;
+    m_cached_input_coords = _input_coords;
+    m_cached_hidden_coords = _hidden_coords;
+    m_cached_output_coords = _output_coords;
+
+    // the neurons in the order of the phenotype
+    const unsigned int t_num_inputs = _input_coords.size();
+    const unsigned int t_num_hidden = _hidden_coords.size();
+    const unsigned int t_num_outputs = _output_coords.size();
+    const unsigned int t_num_neurons = t_num_inputs + t_num_hidden + t_num_outputs;
+    const unsigned int t_max_dims = GetMaxDims();
+
+    m_packed_coords.assign(t_num_neurons * t_max_dims, 0.0);
+    for(unsigned int i=0; i<t_num_neurons; i++)
+    {
+        const std::vector<double>& t_coords =
+                (i < t_num_inputs) ? _input_coords[i] :
+                (i < t_num_inputs + t_num_hidden) ? _hidden_coords[i - t_num_inputs] :
+                _output_coords[i - t_num_inputs - t_num_hidden];
+
+        std::copy(t_coords.begin(), t_coords.end(), m_packed_coords.begin() + i * t_max_dims);
+    }
+
+    // Whether links are allowed depends only on the types of the two neurons,
+    // [source type][target type]
+    bool t_allowed[OUTPUT + 1][OUTPUT + 1];
+    for(int from=0; from<=OUTPUT; from++)
+        for(int to=0; to<=OUTPUT; to++)
+            t_allowed[from][to] = true;
+
+    t_allowed[INPUT][HIDDEN]   = m_allow_input_hidden_links;
+    t_allowed[INPUT][OUTPUT]   = m_allow_input_output_links;
+    t_allowed[HIDDEN][HIDDEN]  = m_allow_hidden_hidden_links;
+    t_allowed[HIDDEN][OUTPUT]  = m_allow_hidden_output_links;
+    t_allowed[OUTPUT][HIDDEN]  = m_allow_output_hidden_links;
+    // m_allow_output_output_links has always been checked against input->output links
+    t_allowed[INPUT][OUTPUT]   = t_allowed[INPUT][OUTPUT] && m_allow_output_output_links;
+
+    // and a neuron linked to itself
+    bool t_allowed_looped[OUTPUT + 1];
+    t_allowed_looped[HIDDEN] = m_allow_looped_hidden_links;
+    t_allowed_looped[OUTPUT] = m_allow_looped_output_links;
+
+    // the neurons of each type are next to each other
+    const NeuronType t_types[3] = { INPUT, HIDDEN, OUTPUT };
+    const unsigned int t_begin[3] = { 0, t_num_inputs, t_num_inputs + t_num_hidden };
+    const unsigned int t_end[3] = { t_num_inputs, t_num_inputs + t_num_hidden, t_num_neurons };
+
+    m_link_ranges.clear();
+
+    // only incoming connections, so only the hidden and output neurons are targets
+    for(unsigned int i=t_num_inputs; i<t_num_neurons; i++)
+    {
+        const NeuronType t_to = (i < t_num_inputs + t_num_hidden) ? HIDDEN : OUTPUT;
+
+        for(int k=0; k<3; k++)
+        {
+            if (!t_allowed[t_types[k]][t_to] || (t_begin[k] == t_end[k]))
+                continue;
+
+            if ((i >= t_begin[k]) && (i < t_end[k]) && !t_allowed_looped[t_to])
+            {
+                // skip the link to itself
+                if (i > t_begin[k])
+                    m_link_ranges.push_back(LinkRange{ i, t_begin[k], i });
+                if (i + 1 < t_end[k])
+                    m_link_ranges.push_back(LinkRange{ i, i + 1, t_end[k] });
+            }
+            else
+            {
+                m_link_ranges.push_back(LinkRange{ i, t_begin[k], t_end[k] });
+            }
+        }
+    }
+
+    m_cache_valid = true;
+}
+
+const std::vector<Substrate::LinkRange>& Substrate::GetLinkRanges()
+{
+    UpdateLinkCache();
+    return m_link_ranges;
+}
+
+const std::vector<double>& Substrate::GetPackedCoords()
+{
+    UpdateLinkCache();
+    return m_packed_coords;
+}
+
 }
 
@@ -26,6 +26,7 @@
 ///////////////////////////////////////////////////////////////////////////////////////////
 
 #include <vector>
+#include <mutex>
 
 #include <boost/python.hpp>
 #include <boost/archive/binary_oarchive.hpp>
@@ -92,6 +93,52 @@ public:
 
     // Prints some info about itself
     void PrintInfo();
+
+    // A run of links that BuildHyperNEATPhenotype() queries: from the neurons
+    // [m_source_begin, m_source_end) to m_target. The indices are those of the
+    // phenotype - the inputs, then the hidden, then the output neurons.
+    struct LinkRange
+    {
+        unsigned int m_target;
+        unsigned int m_source_begin;
+        unsigned int m_source_end;
+    };
+
+    // The links allowed by the m_allow_* flags, ordered by target and then by source.
+    // Computed on first use and then again only if the coordinates or the flags change.
+    // Several threads may call it at once (building phenotypes in parallel),
+    // but not while another one changes the substrate.
+    const std::vector<LinkRange>& GetLinkRanges();
+
+    // The coordinates of all neurons (in the same order) packed in one array,
+    // each one padded with zeros to GetMaxDims() values. Cached like GetLinkRanges().
+    const std::vector<double>& GetPackedCoords();
+
+private:
+    // the cached tables and the coordinates and flags they were computed for
+    std::vector<LinkRange> m_link_ranges;
+    std::vector<double> m_packed_coords;
+    std::vector< std::vector<double> > m_cached_input_coords;
+    std::vector< std::vector<double> > m_cached_hidden_coords;
+    std::vector< std::vector<double> > m_cached_output_coords;
+    std::vector<bool> m_cached_flags;
+    bool m_cache_valid = false;
+
+    // Guards the cached tables. A copy of the substrate gets a mutex of its own.
+    struct CacheMutex
+    {
+        std::mutex m_Mutex;
+
+        CacheMutex() {}
+        CacheMutex(const CacheMutex&) {}
+        CacheMutex& operator=(const CacheMutex&) { return *this; }
+    };
+    CacheMutex m_cache_mutex;
+
+    std::vector<bool> GetLinkFlags() const;
+
+    // recomputes the cached tables if the substrate changed since the last time
+    void UpdateLinkCache();
 };
 }
 
@@ -0,0 +1,229 @@
+///////////////////////////////////////////////////////////////////////////////////////////
+//    MultiNEAT - Python/C++ NeuroEvolution of Augmenting Topologies Library
+//
+//    Copyright (C) 2012 Peter Chervenski
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public License
+//    along with this program.  If not, see < http://www.gnu.org/licenses/ >.
+//
+//    Contact info:
+//
+//    Peter Chervenski < spookey@abv.bg >
+//    Shane Ryan < shane.mcdonald.ryan@gmail.com >
+///////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+// File:        ThreadPool.cpp
+// Description: Implementation of the work-stealing thread pool.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ThreadPool.h"
+
+namespace NEAT
+{
+
+unsigned int ThreadPool::ResolveNumThreads(unsigned int a_NumThreads)
+{
+    if (a_NumThreads > 0)
+        return a_NumThreads;
+
+    return (std::thread::hardware_concurrency() > 0) ? std::thread::hardware_concurrency() : 1;
+}
+
+ThreadPool& EnsureThreadPool(std::shared_ptr<ThreadPool>& a_Pool, unsigned int a_NumThreads)
+{
+    unsigned int t_num_threads = ThreadPool::ResolveNumThreads(a_NumThreads);
+    if ((!a_Pool) || (a_Pool->NumThreads() != t_num_threads))
+    {
+        a_Pool = std::make_shared<ThreadPool>(t_num_threads);
+    }
+
+    return *a_Pool;
+}
+
+ThreadPool::ThreadPool(unsigned int a_NumThreads):
+    m_Ranges(ResolveNumThreads(a_NumThreads)),
+    m_Job(NULL), m_JobID(0), m_Busy(0), m_Stop(false), m_Failed(false)
+{
+    // worker 0 is the thread calling ParallelFor()
+    for (unsigned int i = 1; i < m_Ranges.size(); i++)
+    {
+        m_Threads.push_back(std::thread(&ThreadPool::WorkerLoop, this, i));
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::unique_lock<std::mutex> t_lock(m_Mutex);
+        m_Stop = true;
+    }
+    m_WakeUp.notify_all();
+
+    for (unsigned int i = 0; i < m_Threads.size(); i++)
+    {
+        m_Threads[i].join();
+    }
+}
+
+void ThreadPool::WorkerLoop(unsigned int a_Worker)
+{
+    unsigned int t_last_job = 0;
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> t_lock(m_Mutex);
+            while ((!m_Stop) && (m_JobID == t_last_job))
+                m_WakeUp.wait(t_lock);
+
+            if (m_Stop)
+                return;
+
+            t_last_job = m_JobID;
+        }
+
+        RunWorker(a_Worker);
+
+        {
+            std::unique_lock<std::mutex> t_lock(m_Mutex);
+            m_Busy--;
+            if (m_Busy == 0)
+                m_Done.notify_all();
+        }
+    }
+}
+
+bool ThreadPool::PopLocal(unsigned int a_Worker, unsigned int& a_Index)
+{
+    WorkRange& t_range = m_Ranges[a_Worker];
+    std::unique_lock<std::mutex> t_lock(t_range.m_Mutex);
+    if (t_range.m_Begin >= t_range.m_End)
+        return false;
+
+    a_Index = t_range.m_Begin++;
+    return true;
+}
+
+bool ThreadPool::Steal(unsigned int a_Worker)
+{
+    const unsigned int t_num = NumThreads();
+    for (unsigned int k = 1; k < t_num; k++)
+    {
+        WorkRange& t_victim = m_Ranges[(a_Worker + k) % t_num];
+        unsigned int t_begin, t_end;
+        {
+            std::unique_lock<std::mutex> t_lock(t_victim.m_Mutex);
+            if (t_victim.m_Begin >= t_victim.m_End)
+                continue;
+
+            // take the back half, at least one
+            unsigned int t_left = t_victim.m_End - t_victim.m_Begin;
+            t_begin = t_victim.m_End - (t_left + 1) / 2;
+            t_end = t_victim.m_End;
+            t_victim.m_End = t_begin;
+        }
+
+        WorkRange& t_own = m_Ranges[a_Worker];
+        std::unique_lock<std::mutex> t_lock(t_own.m_Mutex);
+        t_own.m_Begin = t_begin;
+        t_own.m_End = t_end;
+        return true;
+    }
+
+    return false;
+}
+
+void ThreadPool::RunWorker(unsigned int a_Worker)
+{
+    for (;;)
+    {
+        unsigned int t_index;
+        if (!PopLocal(a_Worker, t_index))
+        {
+            if (!Steal(a_Worker))
+                return;
+            continue;
+        }
+
+        if (m_Failed)
+            continue; // drain quickly
+
+        try
+        {
+            (*m_Job)(t_index);
+        }
+        catch (...)
+        {
+            std::unique_lock<std::mutex> t_lock(m_Mutex);
+            if (!m_Failed)
+            {
+                m_Failed = true;
+                m_Exception = std::current_exception();
+            }
+        }
+    }
+}
+
+void ThreadPool::ParallelFor(unsigned int a_Count, const std::function<void(unsigned int)>& a_Func)
+{
+    if (a_Count == 0)
+        return;
+
+    const unsigned int t_num = NumThreads();
+
+    // nothing to gain from waking the workers
+    if ((t_num == 1) || (a_Count == 1))
+    {
+        for (unsigned int i = 0; i < a_Count; i++)
+            a_Func(i);
+        return;
+    }
+
+    std::unique_lock<std::mutex> t_job_lock(m_JobMutex);
+
+    // split the range evenly, stealing evens out the rest
+    for (unsigned int w = 0; w < t_num; w++)
+    {
+        std::unique_lock<std::mutex> t_lock(m_Ranges[w].m_Mutex);
+        m_Ranges[w].m_Begin = static_cast<unsigned int>((static_cast<unsigned long long>(a_Count) * w) / t_num);
+        m_Ranges[w].m_End = static_cast<unsigned int>((static_cast<unsigned long long>(a_Count) * (w + 1)) / t_num);
+    }
+
+    {
+        std::unique_lock<std::mutex> t_lock(m_Mutex);
+        m_Job = &a_Func;
+        m_Failed = false;
+        m_Exception = std::exception_ptr();
+        m_Busy = t_num - 1;
+        m_JobID++;
+    }
+    m_WakeUp.notify_all();
+
+    RunWorker(0);
+
+    std::exception_ptr t_exception;
+    {
+        std::unique_lock<std::mutex> t_lock(m_Mutex);
+        while (m_Busy > 0)
+            m_Done.wait(t_lock);
+
+        m_Job = NULL;
+        t_exception = m_Exception;
+        m_Exception = std::exception_ptr();
+    }
+
+    if (t_exception)
+        std::rethrow_exception(t_exception);
+}
+
+} // namespace NEAT
@@ -0,0 +1,113 @@
+#ifndef _THREADPOOL_H
+#define _THREADPOOL_H
+
+///////////////////////////////////////////////////////////////////////////////////////////
+//    MultiNEAT - Python/C++ NeuroEvolution of Augmenting Topologies Library
+//
+//    Copyright (C) 2012 Peter Chervenski
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public License
+//    along with this program.  If not, see < http://www.gnu.org/licenses/ >.
+//
+//    Contact info:
+//
+//    Peter Chervenski < spookey@abv.bg >
+//    Shane Ryan < shane.mcdonald.ryan@gmail.com >
+///////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+// File:        ThreadPool.h
+// Description: A small work-stealing thread pool for the parallel loops.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+#include <atomic>
+#include <memory>
+
+namespace NEAT
+{
+
+class ThreadPool
+{
+    // The part of the index range a worker still has to do.
+    // The owner takes from the front, thieves take the back half.
+    struct WorkRange
+    {
+        std::mutex m_Mutex;
+        unsigned int m_Begin;
+        unsigned int m_End;
+    };
+
+    std::vector<std::thread> m_Threads;
+    std::vector<WorkRange> m_Ranges;
+
+    // the job being run
+    const std::function<void(unsigned int)>* m_Job;
+    unsigned int m_JobID;
+    unsigned int m_Busy;
+    bool m_Stop;
+    std::atomic<bool> m_Failed;
+    std::exception_ptr m_Exception;
+
+    // one job at a time when the pool is shared between threads
+    std::mutex m_JobMutex;
+
+    std::mutex m_Mutex;
+    std::condition_variable m_WakeUp;
+    std::condition_variable m_Done;
+
+    // the loop of the background threads
+    void WorkerLoop(unsigned int a_Worker);
+
+    // does the own range, then steals until there is nothing left
+    void RunWorker(unsigned int a_Worker);
+
+    bool PopLocal(unsigned int a_Worker, unsigned int& a_Index);
+    bool Steal(unsigned int a_Worker);
+
+    ThreadPool(const ThreadPool&);
+    ThreadPool& operator=(const ThreadPool&);
+
+public:
+
+    // Creates a pool with a_NumThreads workers, counting the calling thread.
+    // 0 means as many as the hardware supports.
+    ThreadPool(unsigned int a_NumThreads = 0);
+    ~ThreadPool();
+
+    unsigned int NumThreads() const { return static_cast<unsigned int>(m_Ranges.size()); }
+
+    // How many workers a pool created with a_NumThreads has
+    static unsigned int ResolveNumThreads(unsigned int a_NumThreads);
+
+    // Calls a_Func(i) for every i in [0, a_Count) and returns when all calls are done.
+    // The calling thread works as well. The order of the calls is not defined.
+    // If a call throws, the remaining work is skipped and the exception is rethrown here.
+    // Calls from different threads are serialized.
+    // Not reentrant - a_Func must not call ParallelFor() on the same pool.
+    void ParallelFor(unsigned int a_Count, const std::function<void(unsigned int)>& a_Func);
+};
+
+// Returns the pool in a_Pool, created again if there is none or if it doesn't have
+// the number of workers a_NumThreads asks for (as in the constructor, 0 is the hardware's).
+// The classes owning a pool use it to follow the NumThreads parameter.
+ThreadPool& EnsureThreadPool(std::shared_ptr<ThreadPool>& a_Pool, unsigned int a_NumThreads);
+
+} // namespace NEAT
+
+#endif
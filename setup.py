@@ -6,6 +6,10 @@ setup(name='MultiNEAT',
       version='0.1',
       py_modules=['MultiNEAT'],
       ext_modules=[Extension('_MultiNEAT', [
+                                            'lib/ActivationKernels.cpp',
+                                            'lib/BehaviorIndex.cpp',
+                                            'lib/BehaviorStore.cpp',
+                                            'lib/Evaluator.cpp',
                                             'lib/EvolvableSubstrate.cpp',
 	                                    'lib/Genome.cpp',
                                             'lib/Innovation.cpp',
@@ -20,9 +24,11 @@ setup(name='MultiNEAT',
                                             'lib/Random.cpp',
                                             'lib/Species.cpp',
                                             'lib/Substrate.cpp',
+                                            'lib/ThreadPool.cpp',
                                             'lib/Utils.cpp'],
 					    include_dirs=['lib'],
-					    extra_compile_args=['-std=c++11'],
+					    extra_compile_args=['-std=c++11', '-pthread'],
+					    extra_link_args=['-pthread'],
                              libraries=['boost_python',
                                         'boost_serialization'])]
       )